@@ -259,6 +259,28 @@ inline double signedVolumeFromFace(gcs::Face &f,
   return signedVolumeFromFace(p[0], p[1], p[2]);
 }
 
+/**
+ * @brief Get the volume of the fans filling the holes of an open mesh
+ *
+ * @param mesh
+ * @param vpg
+ * @return double
+ */
+DLL_PUBLIC inline double getHoleFillVolume(gcs::ManifoldSurfaceMesh &mesh,
+                                           gcs::VertexPositionGeometry &vpg) {
+  double volume = 0;
+  for (gcs::BoundaryLoop bl : mesh.boundaryLoops()) {
+    gcs::Vertex theVertex = bl.halfedge().tailVertex();
+    for (gcs::Halfedge e : bl.adjacentHalfedges()) {
+      if (e.tailVertex() != theVertex && e.tipVertex() != theVertex) {
+        volume += signedVolumeFromFace(e.tailVertex(), e.tipVertex(),
+                                       theVertex, vpg);
+      }
+    }
+  }
+  return volume;
+}
+
 /**
  * @brief Get mesh volume
  *
@@ -274,15 +296,7 @@ DLL_PUBLIC inline double getMeshVolume(gcs::ManifoldSurfaceMesh &mesh,
   // Throw error or fill hole for open mesh
   if (mesh.hasBoundary()) {
     if (isFillHole) {
-      for (gcs::BoundaryLoop bl : mesh.boundaryLoops()) {
-        gcs::Vertex theVertex = bl.halfedge().tailVertex();
-        for (gcs::Halfedge e : bl.adjacentHalfedges()) {
-          if (e.tailVertex() != theVertex && e.tipVertex() != theVertex) {
-            volume += signedVolumeFromFace(e.tailVertex(), e.tipVertex(),
-                                           theVertex, vpg);
-          }
-        }
-      }
+      volume += getHoleFillVolume(mesh, vpg);
     } else {
       mem3dg_runtime_error("Mesh is opened, not able to ",
                            "compute enclosed volume unless filled holes!");
@@ -0,0 +1,118 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+/**
+ * @file parallel.h
+ * @brief Helpers for the (optional) OpenMP threaded kernels and reductions
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#ifdef MEM3DG_WITH_OPENMP
+#include <omp.h>
+#endif
+
+namespace mem3dg {
+
+/**
+ * @brief Resolve the number of threads used by the threaded kernels
+ *
+ * @param nThreads  requested number of threads, 0 for the OpenMP default
+ * @return number of threads, always 1 when built without OpenMP
+ */
+inline int getNumThreads(std::size_t nThreads) {
+#ifdef MEM3DG_WITH_OPENMP
+  return nThreads == 0 ? omp_get_max_threads() : static_cast<int>(nThreads);
+#else
+  return 1;
+#endif
+}
+
+/**
+ * @brief Index of the calling thread in the enclosing parallel region
+ *
+ * @return thread index, always 0 outside of a parallel region or when built
+ * without OpenMP
+ */
+inline int getThreadNum() {
+#ifdef MEM3DG_WITH_OPENMP
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+/// Number of terms per block of parallelSum. Fixed, such that the order of
+/// summation does not depend on the number of threads
+constexpr std::size_t REDUCTION_BLOCK_SIZE = 4096;
+/// Number of block sums of parallelSum kept on the stack, such that sums of up
+/// to REDUCTION_STACK_BLOCKS * REDUCTION_BLOCK_SIZE terms do not allocate
+constexpr std::size_t REDUCTION_STACK_BLOCKS = 64;
+
+/**
+ * @brief Reproducible (threaded) sum of term(i) for i in [0, n). The range is
+ * split into blocks of fixed size, each block is summed with Kahan
+ * compensation, and the block sums are added pairwise in a fixed order, hence
+ * the result is bitwise identical for any number of threads
+ *
+ * @param n         number of terms
+ * @param term      callable returning the i-th term
+ * @param nThreads  requested number of threads, 0 for the OpenMP default
+ * @return sum, non-finite if any term is
+ */
+template <typename F>
+double parallelSum(std::size_t n, F &&term, std::size_t nThreads = 0) {
+  const std::ptrdiff_t nBlocks =
+      (n + REDUCTION_BLOCK_SIZE - 1) / REDUCTION_BLOCK_SIZE;
+  double stackSums[REDUCTION_STACK_BLOCKS];
+  std::vector<double> heapSums;
+  if (nBlocks > static_cast<std::ptrdiff_t>(REDUCTION_STACK_BLOCKS))
+    heapSums.resize(nBlocks);
+  double *blockSums = heapSums.empty() ? stackSums : heapSums.data();
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t b = 0; b < nBlocks; ++b) {
+    const std::size_t begin = b * REDUCTION_BLOCK_SIZE;
+    const std::size_t end = std::min(n, begin + REDUCTION_BLOCK_SIZE);
+    double sum = 0, compensation = 0, naiveSum = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+      const double value = term(i);
+      const double y = value - compensation;
+      const double t = sum + y;
+      compensation = (t - sum) - y;
+      sum = t;
+      naiveSum += value;
+    }
+    // the compensation turns inf into nan, keep the plain sum instead
+    blockSums[b] = std::isfinite(naiveSum) ? sum : naiveSum;
+  }
+
+  // pairwise combination of the block sums
+  const std::size_t nSums = nBlocks;
+  for (std::size_t stride = 1; stride < nSums; stride *= 2) {
+    for (std::size_t b = 0; b + stride < nSums; b += 2 * stride) {
+      blockSums[b] += blockSums[b + stride];
+    }
+  }
+  return nSums == 0 ? 0 : blockSums[0];
+}
+
+} // namespace mem3dg
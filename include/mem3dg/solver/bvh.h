@@ -0,0 +1,179 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#pragma once
+
+#include <array>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <geometrycentral/surface/surface_mesh.h>
+#include <geometrycentral/utilities/vector3.h>
+
+#include "mem3dg/macros.h"
+#include "mem3dg/solver/connectivity.h"
+
+namespace gc = ::geometrycentral;
+namespace gcs = ::geometrycentral::surface;
+
+namespace mem3dg {
+
+namespace solver {
+
+/**
+ * @brief Proximity of two mesh primitives (vertex-face or edge-edge). The
+ * difference of their closest points is sum_k coefficients[k] *
+ * x[vertices[k]], pointing from the second primitive to the first one
+ */
+struct Proximity {
+  /// Vertices of the two primitives
+  std::array<std::size_t, 4> vertices;
+  /// Coefficients of the closest point difference, which are also the
+  /// gradients of the difference wrt the vertex positions
+  std::array<double, 4> coefficients;
+  /// Closest point difference
+  gc::Vector3 difference;
+  /// Interaction weight, e.g. product of the primitive protein densities
+  double weight;
+};
+
+/**
+ * @brief Closest features (vertex, edge or face) of the two primitives of a
+ * proximity, i.e. the vertices of positive and of negative coefficient. Each
+ * feature is sorted and padded with the maximum index, the lower feature
+ * comes first, so that proximities of the same feature pair found from
+ * different primitives, e.g. a vertex closest to an edge shared by two faces,
+ * have the same key
+ */
+DLL_PUBLIC std::array<std::size_t, 6>
+closestFeatures(const Proximity &proximity);
+
+/**
+ * @brief Closest point on triangle abc to point p
+ *
+ * @param barycentric   barycentric coordinates of the closest point
+ */
+DLL_PUBLIC gc::Vector3
+closestPointOnTriangle(const gc::Vector3 &p, const gc::Vector3 &a,
+                       const gc::Vector3 &b, const gc::Vector3 &c,
+                       std::array<double, 3> &barycentric);
+
+/**
+ * @brief Closest points of segments p1q1 and p2q2, p1 + s * (q1 - p1) and
+ * p2 + t * (q2 - p2)
+ */
+DLL_PUBLIC void closestPointsOnSegments(const gc::Vector3 &p1,
+                                        const gc::Vector3 &q1,
+                                        const gc::Vector3 &p2,
+                                        const gc::Vector3 &q2, double &s,
+                                        double &t);
+
+/**
+ * @brief Bounding volume hierarchy (of axis aligned boxes) over the faces.
+ * The topology of the tree is built once from a median split of the face
+ * centroids, and the boxes are refit to new vertex positions in O(N), level
+ * by level from the leaves, each level in parallel.
+ */
+class DLL_PUBLIC FaceBVH {
+public:
+  /// Index of an absent node
+  static constexpr std::size_t INVALID_IND =
+      std::numeric_limits<std::size_t>::max();
+  /// Maximum number of faces of a leaf
+  static constexpr std::size_t LEAF_SIZE = 4;
+
+  /// BVH node
+  struct Node {
+    /// Lower corner of the bounding box
+    gc::Vector3 lower;
+    /// Upper corner of the bounding box
+    gc::Vector3 upper;
+    /// Children, INVALID_IND for a leaf
+    std::size_t left, right;
+    /// Range [begin, end) of the faces in FaceBVH::faces
+    std::size_t begin, end;
+  };
+
+  /// Nodes, root first
+  std::vector<Node> nodes;
+  /// Face indices, grouped by node
+  std::vector<std::size_t> faces;
+  /// Nodes of each depth, for the level by level refit
+  std::vector<std::vector<std::size_t>> levels;
+
+  /**
+   * @brief Build the tree and fit the boxes
+   */
+  void build(const Connectivity &cn,
+             const gcs::VertexData<gc::Vector3> &positions,
+             std::size_t nThreads = 0);
+
+  /**
+   * @brief Refit the boxes to new vertex positions, the topology of the mesh
+   * has to be the same as in build
+   */
+  void refit(const Connectivity &cn,
+             const gcs::VertexData<gc::Vector3> &positions,
+             std::size_t nThreads = 0);
+
+  /**
+   * @brief Visit the candidate faces of a query box, i.e. the faces of the
+   * leaves whose box overlaps the query box
+   *
+   * @param f   f(face), called for every candidate face
+   */
+  template <typename F>
+  void query(const gc::Vector3 &lower, const gc::Vector3 &upper,
+             F &&f) const {
+    if (nodes.empty())
+      return;
+    std::vector<std::size_t> stack{0};
+    while (!stack.empty()) {
+      const Node &node = nodes[stack.back()];
+      stack.pop_back();
+      if (node.upper.x < lower.x || node.lower.x > upper.x ||
+          node.upper.y < lower.y || node.lower.y > upper.y ||
+          node.upper.z < lower.z || node.lower.z > upper.z)
+        continue;
+      if (node.left == INVALID_IND) {
+        for (std::size_t k = node.begin; k < node.end; ++k)
+          f(faces[k]);
+      } else {
+        stack.push_back(node.right);
+        stack.push_back(node.left);
+      }
+    }
+  }
+
+  /**
+   * @brief Vertices of the face
+   */
+  static std::array<std::size_t, 3> faceVertices(const Connectivity &cn,
+                                                 std::size_t f) {
+    std::size_t he = cn.faceHalfedge[f];
+    std::size_t he_next = cn.halfedgeNext[he];
+    return {cn.halfedgeTail[he], cn.halfedgeTail[he_next],
+            cn.halfedgeTail[cn.halfedgeNext[he_next]]};
+  }
+
+private:
+  /// Split the node at the median centroid along its longest axis,
+  /// recursively
+  void split(std::size_t nodeInd, std::size_t depth,
+             const std::vector<gc::Vector3> &centroids);
+};
+
+} // namespace solver
+} // namespace mem3dg
@@ -0,0 +1,152 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <geometrycentral/surface/manifold_surface_mesh.h>
+#include <geometrycentral/surface/surface_mesh.h>
+#include <geometrycentral/utilities/vector3.h>
+
+#include "mem3dg/macros.h"
+
+namespace gc = ::geometrycentral;
+namespace gcs = ::geometrycentral::surface;
+
+namespace mem3dg {
+
+namespace solver {
+
+/**
+ * @brief Flat, index-based snapshot of the mesh connectivity for the hot
+ * loops. Outgoing halfedges of each vertex are stored in CSR form, in the same
+ * order as Vertex::outgoingHalfedges(). Only valid as long as the topology of
+ * the (compressed) mesh does not change; rebuild after mutation.
+ */
+struct DLL_PUBLIC Connectivity {
+  /// Index of an absent element, e.g. the face of an exterior halfedge
+  static constexpr std::size_t INVALID_IND =
+      std::numeric_limits<std::size_t>::max();
+
+  /// Halfedge bitflags
+  enum HalfedgeFlag : std::uint8_t { INTERIOR = 1, BOUNDARY_EDGE = 2 };
+
+  /// Number of vertices at the time of build
+  std::size_t nVertices = 0;
+  /// Number of halfedges (including exterior ones) at the time of build
+  std::size_t nHalfedges = 0;
+  /// Number of edges at the time of build
+  std::size_t nEdges = 0;
+  /// Number of faces at the time of build
+  std::size_t nFaces = 0;
+  /// Whether the mesh has boundary, selects the general (open mesh) kernels
+  bool hasBoundary = false;
+
+  /// CSR row offsets into outgoingHalfedges, nVertices + 1
+  std::vector<std::size_t> outgoingOffsets;
+  /// CSR column of outgoing halfedges of each vertex
+  std::vector<std::size_t> outgoingHalfedges;
+
+  /// Tail vertex of the halfedge
+  std::vector<std::size_t> halfedgeTail;
+  /// Tip vertex of the halfedge
+  std::vector<std::size_t> halfedgeTip;
+  /// Next halfedge
+  std::vector<std::size_t> halfedgeNext;
+  /// Twin halfedge
+  std::vector<std::size_t> halfedgeTwin;
+  /// Edge of the halfedge
+  std::vector<std::size_t> halfedgeEdge;
+  /// Face of the halfedge, INVALID_IND for exterior halfedges
+  std::vector<std::size_t> halfedgeFace;
+  /// Bitflags of HalfedgeFlag
+  std::vector<std::uint8_t> halfedgeFlags;
+
+  /// Canonical halfedge of the edge, Edge::halfedge()
+  std::vector<std::size_t> edgeHalfedge;
+  /// Canonical halfedge of the face, Face::halfedge()
+  std::vector<std::size_t> faceHalfedge;
+  /// Whether the vertex is on the boundary
+  std::vector<std::uint8_t> vertexIsBoundary;
+
+  /**
+   * @brief Rebuild the snapshot from a compressed mesh
+   */
+  void build(gcs::ManifoldSurfaceMesh &mesh);
+
+  /**
+   * @brief Whether the snapshot matches the element counts of the mesh
+   */
+  bool isCurrent(gcs::ManifoldSurfaceMesh &mesh) const {
+    return nVertices == mesh.nVertices() && nHalfedges == mesh.nHalfedges() &&
+           nEdges == mesh.nEdges() && nFaces == mesh.nFaces();
+  }
+
+  bool isInterior(std::size_t he) const {
+    return halfedgeFlags[he] & INTERIOR;
+  }
+  bool isBoundaryEdge(std::size_t he) const {
+    return halfedgeFlags[he] & BOUNDARY_EDGE;
+  }
+  bool isBoundaryVertex(std::size_t v) const { return vertexIsBoundary[v]; }
+
+  /**
+   * @brief Expand a vertex set by its 1-ring
+   *
+   * @param vertices        vertex set, marked in vertexMarker
+   * @param vertexMarker    nVertices marker, updated with the 1-ring
+   * @return expanded vertex set in ascending order
+   */
+  std::vector<std::size_t>
+  expandRing(const std::vector<std::size_t> &vertices,
+             std::vector<std::uint8_t> &vertexMarker) const;
+
+  /**
+   * @brief Immediate (triangle) geometry from vertex positions, used where
+   * the cached geometry may be outdated
+   */
+  gc::Vector3 halfedgeVector(std::size_t he,
+                             const gcs::VertexData<gc::Vector3> &pos) const {
+    return pos[halfedgeTip[he]] - pos[halfedgeTail[he]];
+  }
+  double edgeLength(std::size_t e,
+                    const gcs::VertexData<gc::Vector3> &pos) const {
+    std::size_t he = edgeHalfedge[e];
+    return gc::norm(pos[halfedgeTail[he]] - pos[halfedgeTip[he]]);
+  }
+  gc::Vector3 faceAreaVector(std::size_t f,
+                             const gcs::VertexData<gc::Vector3> &pos) const {
+    std::size_t he = faceHalfedge[f];
+    gc::Vector3 pA = pos[halfedgeTail[he]];
+    he = halfedgeNext[he];
+    gc::Vector3 pB = pos[halfedgeTail[he]];
+    he = halfedgeNext[he];
+    gc::Vector3 pC = pos[halfedgeTail[he]];
+    return gc::cross(pB - pA, pC - pA);
+  }
+  double faceArea(std::size_t f,
+                  const gcs::VertexData<gc::Vector3> &pos) const {
+    return 0.5 * gc::norm(faceAreaVector(f, pos));
+  }
+  gc::Vector3 faceNormal(std::size_t f,
+                         const gcs::VertexData<gc::Vector3> &pos) const {
+    return gc::unit(faceAreaVector(f, pos));
+  }
+};
+
+} // namespace solver
+} // namespace mem3dg
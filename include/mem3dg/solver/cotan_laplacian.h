@@ -0,0 +1,62 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+#include "mem3dg/macros.h"
+#include "mem3dg/solver/connectivity.h"
+
+namespace mem3dg {
+
+namespace solver {
+
+/**
+ * @brief Cotan Laplacian with a frozen sparsity pattern. The pattern and the
+ * map from the outgoing halfedges to the nonzeros are built once per mesh
+ * topology, and the values are updated in place from the edge cotan weights,
+ * column by column in parallel.
+ */
+class DLL_PUBLIC CotanLaplacian {
+public:
+  /// Compressed (symmetric) matrix, sum_j w_ij (x_i - x_j) for row i
+  Eigen::SparseMatrix<double> matrix;
+  /// Nonzero of the (tip, tail) entry of the outgoing halfedge
+  /// Connectivity::outgoingHalfedges[k], indexed by k
+  std::vector<std::size_t> halfedgeNonzeros;
+  /// Nonzero of the diagonal entry of the vertex
+  std::vector<std::size_t> diagonalNonzeros;
+
+  /**
+   * @brief Build the sparsity pattern and the nonzero maps, the values are
+   * set to zero
+   */
+  void build(const Connectivity &cn);
+
+  /**
+   * @brief Update the values from the edge cotan weights, the topology of the
+   * mesh has to be the same as in build
+   */
+  void update(const Connectivity &cn, const Eigen::VectorXd &edgeCotanWeights,
+              std::size_t nThreads = 0);
+};
+
+} // namespace solver
+} // namespace mem3dg
@@ -100,6 +100,12 @@ struct Forces {
   gcs::VertexData<gc::Vector3> capillaryForceVec;
   /// Cached osmotic force
   gcs::VertexData<gc::Vector3> osmoticForceVec;
+  /// Cached (masked) area gradient, capillaryForceVec = -surfaceTension *
+  /// areaGradientVec
+  gcs::VertexData<gc::Vector3> areaGradientVec;
+  /// Cached (masked) volume gradient, osmoticForceVec = osmoticPressure *
+  /// volumeGradientVec
+  gcs::VertexData<gc::Vector3> volumeGradientVec;
   /// Cached Dirichlet energy driven force
   gcs::VertexData<gc::Vector3> lineCapillaryForceVec;
   /// Cached adsorption driven force
@@ -151,6 +157,7 @@ struct Forces {
         bendingForceVec_gaussVec(mesh, {0, 0, 0}),
         bendingForceVec_schlafliVec(mesh, {0, 0, 0}),
         capillaryForceVec(mesh, {0, 0, 0}), osmoticForceVec(mesh, {0, 0, 0}),
+        areaGradientVec(mesh, {0, 0, 0}), volumeGradientVec(mesh, {0, 0, 0}),
         adsorptionForceVec(mesh, {0, 0, 0}),
         aggregationForceVec(mesh, {0, 0, 0}), externalForceVec(mesh, {0, 0, 0}),
         selfAvoidanceForceVec(mesh, {0, 0, 0}),
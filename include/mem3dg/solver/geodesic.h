@@ -0,0 +1,142 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseCore>
+
+#include <geometrycentral/surface/surface_mesh.h>
+#include <geometrycentral/utilities/vector3.h>
+
+#include "mem3dg/macros.h"
+#include "mem3dg/solver/connectivity.h"
+#include "mem3dg/solver/cotan_laplacian.h"
+
+namespace gc = ::geometrycentral;
+namespace gcs = ::geometrycentral::surface;
+
+namespace mem3dg {
+
+namespace solver {
+
+/**
+ * @brief Heat method geodesic distance (Crane et al. 2013) with persistent
+ * factorizations. The symbolic analysis of the heat and Poisson systems is
+ * done once per mesh topology, and their numeric factorization is reused
+ * until a vertex drifts from the factorized geometry by more than a tolerance
+ * (relative to the mean edge length). The gradient and divergence always use
+ * the current geometry. On meshes with boundary the heat flow is the average
+ * of the Neumann and zero Dirichlet boundary conditions, as in
+ * gcs::HeatMethodDistanceSolver. Local distances are computed by fast
+ * marching instead, which terminates at a given radius.
+ */
+class DLL_PUBLIC GeodesicSolver {
+public:
+  /// Vertex weights of a source point, e.g. its barycentric coordinates
+  using Source = std::vector<std::pair<std::size_t, double>>;
+
+  /// Time step of the heat flow in units of the squared mean edge length
+  double tCoef = 1;
+  /// Number of symbolic analyses
+  std::size_t nAnalyses = 0;
+  /// Number of numeric factorizations
+  std::size_t nFactorizations = 0;
+
+  /**
+   * @brief Analyze the sparsity pattern of the mesh, needed after every
+   * change of the mesh topology
+   */
+  void analyze(const Connectivity &cn);
+
+  /**
+   * @brief Compute the geodesic distance from the source point, which is
+   * zero at the source
+   *
+   * @param tolerance   vertex drift, relative to the mean edge length, up to
+   * which the factorization is reused
+   */
+  void computeDistance(const Connectivity &cn,
+                       const gcs::VertexData<gc::Vector3> &positions,
+                       const Source &source, Eigen::VectorXd &distance,
+                       double tolerance = 0, std::size_t nThreads = 0);
+
+  /**
+   * @brief Compute the geodesic distance from the source point by fast
+   * marching (Kimmel and Sethian 1998), terminated at the radius. The work is
+   * proportional to the number of vertices within the radius, the distance of
+   * the other vertices is clamped to the radius. If the distance is the one
+   * left by the previous march with the same radius, only the vertices it
+   * touched are reset
+   *
+   * @return number of vertices within the radius
+   */
+  std::size_t computeBoundedDistance(
+      const Connectivity &cn, const gcs::VertexData<gc::Vector3> &positions,
+      const Source &source, double radius, Eigen::VectorXd &distance);
+
+  /**
+   * @brief Forget the previous march, needed after the distance has been
+   * written elsewhere, e.g. after mesh mutation
+   */
+  void invalidateBoundedDistance() { markedDistance = nullptr; }
+
+private:
+  /// Cotan Laplacian of the factorized geometry
+  CotanLaplacian laplacian;
+  /// Factorization of M + t L
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> heatSolver;
+  /// Selection of the interior vertices, empty without boundary
+  Eigen::SparseMatrix<double> interiorSelection;
+  /// Factorization of the interior block of M + t L, the heat flow with zero
+  /// boundary values
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> dirichletHeatSolver;
+  /// Factorization of L, shifted by a tiny multiple of M
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> poissonSolver;
+  /// Vertex positions of the factorization
+  std::vector<gc::Vector3> factorizedPositions;
+  /// Mean edge length of the factorization
+  double meanEdgeLength = 0;
+  /// Whether the pattern is analyzed
+  bool isAnalyzed = false;
+  /// Whether the numeric factorization is valid
+  bool isFactorized = false;
+  /// Normalized negative heat gradient of the faces
+  std::vector<gc::Vector3> faceFields;
+  /// Whether the vertex is accepted by fast marching
+  std::vector<std::uint8_t> isAccepted;
+  /// Vertices whose distance is below the radius after the previous march
+  std::vector<std::size_t> touchedVertices;
+  /// Distance of the previous march, nullptr if unknown
+  const double *markedDistance = nullptr;
+  /// Radius of the previous march
+  double markedRadius = 0;
+  /// Trial (distance, vertex) min-heap of fast marching
+  std::vector<std::pair<double, std::size_t>> trials;
+
+  /// Factorize the operators of the current geometry
+  void factorize(const Connectivity &cn,
+                 const gcs::VertexData<gc::Vector3> &positions,
+                 std::size_t nThreads);
+};
+
+} // namespace solver
+} // namespace mem3dg
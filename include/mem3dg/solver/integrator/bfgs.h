@@ -30,6 +30,8 @@ namespace integrator {
  * @param rho, backtracking coefficient
  * @param c1, Wolfe condition parameter
  * @param isAugmentedLagrangian, option to use Augmented Lagrangian method
+ * @param lineSearch, line search algorithm, "backtrack" or "moreThuente"
+ * @param c2, curvature condition parameter of the More-Thuente line search
  * @return Success, if simulation is sucessful
  */
 class DLL_PUBLIC BFGS : public Integrator {
@@ -49,6 +51,8 @@ public:
   const double ctol;
   const bool isAugmentedLagrangian;
   bool ifRestart;
+  std::string lineSearch = "backtrack";
+  double c2 = 0.9;
   BFGS(System &system_, double characteristicTimeStep_, double totalTime_,
        double savePeriod_, double tolerance_, std::string outputDirectory_,
        bool isAdaptiveStep_, std::string trajFileName_, std::size_t verbosity_,
@@ -23,9 +23,11 @@ namespace integrator {
 /**
  * @brief Conjugate Gradient propagator
  * @param ctol, tolerance for termination (contraints)
- * @param isBacktrack, option to use backtracking line search algorithm
+ * @param isBacktrack, option to use line search algorithm
+ * @param lineSearch, line search algorithm, "backtrack" or "moreThuente"
  * @param rho, backtracking coefficient
  * @param c1, Wolfe condition parameter
+ * @param c2, curvature condition parameter of the More-Thuente line search
  * @param isAugmentedLagrangian, option to use Augmented Lagrangian method
  * @return Success, if simulation is sucessful
  */
@@ -39,8 +41,10 @@ private:
 public:
   std::size_t restartPeriod = 5;
   bool isBacktrack = true;
+  std::string lineSearch = "backtrack";
   double rho = 0.9;
   double c1 = 0.0005;
+  double c2 = 0.1;
   double constraintTolerance = 0.01;
   bool isAugmentedLagrangian = false;
 
@@ -22,16 +22,20 @@ namespace solver {
 namespace integrator {
 /**
  * @brief Euler (gradient descent) time Integration
- * @param isBacktrack, option to use backtracking line search algorithm
+ * @param isBacktrack, option to use line search algorithm
+ * @param lineSearch, line search algorithm, "backtrack" or "moreThuente"
  * @param rho, backtracking coefficient
  * @param c1, Wolfe condition parameter
+ * @param c2, curvature condition parameter of the More-Thuente line search
  * @return Success, if simulation is sucessful
  */
 class DLL_PUBLIC Euler : public Integrator {
 public:
   bool isBacktrack = true;
+  std::string lineSearch = "backtrack";
   double rho = 0.7;
   double c1 = 0.0005;
+  double c2 = 0.9;
 
   Euler(System &system_, double characteristicTimeStep_, double totalTime_,
         double savePeriod_, double tolerance_, std::string outputDirectory_)
@@ -70,6 +70,21 @@ protected:
   double dt_size2_ratio;
   /// initial maximum force
   double initialMaximumForce;
+  /// Line search workspace, vertex positions at the start of the line search
+  EigenVectorX3dr initialPosition;
+  /// Line search workspace, protein density at the start of the line search
+  EigenVectorX1d initialProteinDensity;
+  /// Line search workspace, vertex positions of the trial step
+  EigenVectorX3dr trialPosition;
+  /// Line search workspace, protein density of the trial step
+  EigenVectorX1d trialProteinDensity;
+  /// Initial step of backtrack, as fraction of characteristicTimeStep
+  double stepFraction = 1;
+  /// Initial step of mechanicalBacktrack, as fraction of
+  /// characteristicTimeStep
+  double mechanicalStepFraction = 1;
+  /// Initial step of chemicalBacktrack, as fraction of characteristicTimeStep
+  double chemicalStepFraction = 1;
   /// TrajFile
 #ifdef MEM3DG_WITH_NETCDF
   TrajFile trajFile;
@@ -102,6 +117,24 @@ public:
   size_t verbosity = 3;
   /// just save geometry .ply file
   bool isJustGeometryPly = false;
+  /// number of energy evaluations of the line searches
+  std::size_t nEnergyEvaluations = 0;
+  /// option to start the backtracking from the last accepted step instead of
+  /// characteristicTimeStep
+  bool isWarmStartStep = false;
+  /// growth factor of the initial step after acceptance at the initial step,
+  /// >= 1
+  double stepGrowth = 2;
+
+  /// Acceptance statistics of the backtracking since the last save
+  struct LineSearchStatistics {
+    /// Number of line searches
+    std::size_t nSearches = 0;
+    /// Number of line searches accepted at the initial step
+    std::size_t nInitialAcceptances = 0;
+    /// Number of trial steps
+    std::size_t nTrials = 0;
+  } lineSearchStatistics;
 
   // ==========================================================
   // =============        Constructor            ==============
@@ -130,6 +163,9 @@ public:
     dt_size2_ratio = characteristicTimeStep /
                      std::pow(system.vpg->edgeLengths.raw().minCoeff(), 2);
 
+    // Select the force kernel of the active energy terms
+    system.updateActiveForceTerms();
+
     // Initialize the initial maxForce
     system.computePhysicalForcing(timeStep);
     initialMaximumForce =
@@ -235,44 +271,71 @@ public:
 
   /**
    * @brief Backtracking algorithm that dynamically adjust step size based on
-   * energy evaluation
-   * @param positionDirection, direction of shape, most likely some function of
-   * gradient
-   * @param chemicalDirection, direction of protein density, most likely some
-   * function of gradient
+   * energy evaluation along system.velocity and system.proteinVelocity, which
+   * are replaced by the bare gradient if uphill. The accepted step is taken,
+   * i.e. the system is left at the accepted configuration and time with
+   * updated configurations
    * @param rho, discount factor
    * @param c1, constant for Wolfe condtion, between 0 to 1, usually ~ 1e-4
    * @return alpha, line search step size
    */
-  double backtrack(Eigen::Matrix<double, Eigen::Dynamic, 3> &&positionDirection,
-                   Eigen::Matrix<double, Eigen::Dynamic, 1> &&chemicalDirection,
-                   double rho = 0.7, double c1 = 0.001);
+  double backtrack(double rho = 0.7, double c1 = 0.001);
+
+  /**
+   * @brief More-Thuente line search along system.velocity and
+   * system.proteinVelocity, which are replaced by the bare gradient if
+   * uphill. It safeguards the cubic and quadratic interpolation of the energy
+   * and its directional derivative, -forces·direction, to find a step size
+   * in (0, characteristicTimeStep] that satisfies the strong Wolfe
+   * conditions. The accepted step is taken, i.e. the system is left at the
+   * accepted configuration and time with updated configurations and forces
+   * @param c1, constant for sufficient decrease, usually ~ 1e-4
+   * @param c2, constant for curvature condition, c1 < c2 < 1
+   * @return alpha, line search step size
+   */
+  double wolfeLineSearch(double c1 = 0.001, double c2 = 0.9);
 
   /**
    * @brief Backtracking algorithm that dynamically adjust step size based on
-   * energy evaluation
-   * @param positionDirection, direction of shape, most likely some function of
-   * gradient
+   * energy evaluation along system.velocity, which is replaced by the bare
+   * gradient if uphill. The system is left at the initial configuration and
+   * time, but the cached quantities may be of a trial configuration, hence
+   * the caller takes the step and updates the configurations
    * @param rho, discount factor
    * @param c1, constant for Wolfe condtion, between 0 to 1, usually ~ 1e-4
    * @return alpha, line search step size
    */
-  double mechanicalBacktrack(
-      Eigen::Matrix<double, Eigen::Dynamic, 3> &&positionDirection,
-      double rho = 0.7, double c1 = 0.001);
+  double mechanicalBacktrack(double rho = 0.7, double c1 = 0.001);
 
   /**
    * @brief Backtracking algorithm that dynamically adjust step size based on
-   * energy evaluation
-   * @param chemicalDirection, direction of protein density, most likely some
-   * function of gradient
+   * energy evaluation along system.proteinVelocity, which is replaced by the
+   * bare gradient if uphill. The system is left at the initial configuration
+   * and time, but the cached quantities may be of a trial configuration, hence
+   * the caller takes the step and updates the configurations
    * @param rho, discount factor
    * @param c1, constant for Wolfe condtion, between 0 to 1, usually ~ 1e-4
    * @return alpha, line search step size
    */
-  double chemicalBacktrack(
-      Eigen::Matrix<double, Eigen::Dynamic, 1> &&chemicalDirection,
-      double rho = 0.7, double c1 = 0.001);
+  double chemicalBacktrack(double rho = 0.7, double c1 = 0.001);
+
+  /**
+   * @brief Initial step of a backtracking line search, which starts from the
+   * remembered fraction of characteristicTimeStep if warm started
+   * @param fraction, remembered fraction of the line search
+   * @return alpha, initial step size
+   */
+  double getInitialStep(double fraction) const;
+
+  /**
+   * @brief Remember the accepted step of a backtracking line search as
+   * fraction of characteristicTimeStep, which grows by stepGrowth if accepted
+   * at the initial step, and record the acceptance statistics
+   * @param fraction, remembered fraction of the line search
+   * @param alpha, accepted step size
+   * @param count, number of backtracking iterations
+   */
+  void updateStepMemory(double &fraction, double alpha, std::size_t count);
 
   /**
    * @brief Check finiteness of simulation states and backtrack for error in
@@ -0,0 +1,144 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2021:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#pragma once
+
+#include <deque>
+
+#include "mem3dg/solver/integrator/integrator.h"
+#include "mem3dg/solver/system.h"
+
+namespace mem3dg {
+namespace solver {
+namespace integrator {
+// ==========================================================
+// =============             L-BFGS             =============
+// ==========================================================
+/**
+ * @brief Limited-memory BFGS optimizer, which applies the inverse Hessian
+ * approximation of the last historyLength steps by the two-loop recursion,
+ * instead of storing the dense matrix as BFGS. The steps are always line
+ * searched
+ * @param historyLength, number of steps kept in the history
+ * @param lineSearch, line search algorithm, "backtrack" or "moreThuente"
+ * @param rho, backtracking coefficient
+ * @param c1, Wolfe condition parameter
+ * @param c2, curvature condition parameter of the More-Thuente line search
+ * @param ctol, tolerance for termination (contraints)
+ * @param isAugmentedLagrangian, option to use Augmented Lagrangian method
+ * @return Success, if simulation is sucessful
+ */
+class DLL_PUBLIC LBFGS : public Integrator {
+private:
+  /// History of the position steps, oldest first
+  std::deque<EigenVectorX1d> s;
+  /// History of the (flattened) mechanical gradient differences
+  std::deque<EigenVectorX1d> y;
+  /// History of the protein density steps, oldest first
+  std::deque<EigenVectorX1d> s_protein;
+  /// History of the chemical gradient differences
+  std::deque<EigenVectorX1d> y_protein;
+  /// Last step, added to the history at the next status
+  EigenVectorX1d pastStep;
+  EigenVectorX1d pastStep_protein;
+  /// Forces at the start of the last step
+  EigenVectorX1d pastPhysicalForce;
+  EigenVectorX1d pastPhysicalForce_protein;
+  /// Whether the last step is yet to be added to the history
+  bool isStepPending = false;
+
+public:
+  std::size_t historyLength = 10;
+  std::string lineSearch = "backtrack";
+  double rho = 0.99;
+  double c1 = 0.0001;
+  double c2 = 0.9;
+  double ctol = 0.001;
+  bool isAugmentedLagrangian = false;
+
+  LBFGS(System &system_, double characteristicTimeStep_, double totalTime_,
+        double savePeriod_, double tolerance_, std::string outputDirectory_)
+      : Integrator(system_, characteristicTimeStep_, totalTime_, savePeriod_,
+                   tolerance_, outputDirectory_) {
+
+    // print to console
+    std::cout << "Running L-BFGS propagator ..." << std::endl;
+
+    // check the validity of parameter
+    checkParameters();
+  }
+
+  /**
+   * @brief L-BFGS function
+   */
+  bool integrate() override;
+
+  /**
+   * @brief L-BFGS stepper
+   */
+  void march() override;
+
+  /**
+   * @brief L-BFGS status computation and thresholding
+   */
+  void status() override;
+
+  /**
+   * @brief Check parameters for time integration
+   */
+  void checkParameters() override;
+
+  /**
+   * @brief Clear the history, i.e. restart from the identity inverse Hessian
+   */
+  void clearHistory();
+
+  /**
+   * @brief Number of steps in the history
+   */
+  std::size_t getHistorySize() const { return s.size(); }
+
+  /**
+   * @brief step for n iterations
+   */
+  void step(std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+      status();
+      march();
+    }
+  }
+
+private:
+  /**
+   * @brief Append the step and gradient difference to the history, unless
+   * they violate the curvature condition, and drop the oldest beyond
+   * historyLength
+   */
+  void pushHistory(std::deque<EigenVectorX1d> &steps,
+                   std::deque<EigenVectorX1d> &differences,
+                   const EigenVectorX1d &step,
+                   const EigenVectorX1d &difference);
+
+  /**
+   * @brief Apply the inverse Hessian approximation of the history to the
+   * vector in place, by the two-loop recursion with the identity as the
+   * initial approximation
+   */
+  void applyInverseHessian(const std::deque<EigenVectorX1d> &steps,
+                           const std::deque<EigenVectorX1d> &differences,
+                           EigenVectorX1d &vector) const;
+};
+} // namespace integrator
+} // namespace solver
+} // namespace mem3dg
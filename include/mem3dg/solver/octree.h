@@ -0,0 +1,133 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <geometrycentral/surface/surface_mesh.h>
+#include <geometrycentral/utilities/vector3.h>
+
+#include "mem3dg/macros.h"
+
+namespace gc = ::geometrycentral;
+namespace gcs = ::geometrycentral::surface;
+
+namespace mem3dg {
+
+namespace solver {
+
+/**
+ * @brief Octree of weighted vertices for Barnes-Hut (tree code) evaluation of
+ * pairwise interactions. Every node carries the monopole of its vertices,
+ * i.e. the total weight and the weighted center.
+ */
+class DLL_PUBLIC Octree {
+public:
+  /// Index of an absent node
+  static constexpr std::size_t INVALID_IND =
+      std::numeric_limits<std::size_t>::max();
+  /// Maximum number of vertices of a leaf
+  static constexpr std::size_t LEAF_SIZE = 8;
+  /// Maximum depth, limits the subdivision of coincident vertices
+  static constexpr std::size_t MAX_DEPTH = 32;
+
+  /// Octree node
+  struct Node {
+    /// Center of the cubic bounding box
+    gc::Vector3 center;
+    /// Half of the edge length of the bounding box
+    double halfSize;
+    /// Total weight of the vertices
+    double weight;
+    /// Weighted center of the vertices, valid if weight != 0
+    gc::Vector3 weightedCenter;
+    /// Range [begin, end) of the vertices in Octree::vertices
+    std::size_t begin, end;
+    /// First of the children, which are contiguous, INVALID_IND for a leaf
+    std::size_t firstChild;
+    /// Number of (non-empty) children
+    std::size_t nChildren;
+  };
+
+  /// Nodes, root first
+  std::vector<Node> nodes;
+  /// Vertex indices, grouped by node
+  std::vector<std::size_t> vertices;
+
+  /**
+   * @brief Rebuild the tree
+   *
+   * @param positions   vertex positions
+   * @param weights     vertex weights of the monopoles
+   */
+  void build(const gcs::VertexData<gc::Vector3> &positions,
+             const gcs::VertexData<double> &weights);
+
+  /**
+   * @brief Visit the tree from a target point. A node whose box edge length
+   * is less than theta times the distance from its weighted center to the
+   * point, and whose box lies farther than the exclusion radius from the
+   * point, is accepted as a monopole, otherwise it is opened. For nonnegative
+   * weights the weighted center then lies beyond the exclusion radius as well
+   *
+   * @param x       target point
+   * @param theta   opening angle
+   * @param radius  exclusion radius, nodes reaching into it are always opened
+   * @param near    near(j), called for every vertex j of the opened leaves
+   * @param far     far(weightedCenter, weight), called for every accepted
+   * node of nonzero weight
+   */
+  template <typename Near, typename Far>
+  void traverse(const gc::Vector3 &x, double theta, double radius,
+                Near &&near, Far &&far) const {
+    if (nodes.empty())
+      return;
+    std::size_t stack[8 * MAX_DEPTH + 1];
+    std::size_t nStack = 0;
+    stack[nStack++] = 0;
+    while (nStack > 0) {
+      const Node &node = nodes[stack[--nStack]];
+      gc::Vector3 r = node.center - x;
+      gc::Vector3 gap{std::max(std::abs(r.x) - node.halfSize, 0.0),
+                      std::max(std::abs(r.y) - node.halfSize, 0.0),
+                      std::max(std::abs(r.z) - node.halfSize, 0.0)};
+      if (gc::norm2(gap) > radius * radius &&
+          2 * node.halfSize < theta * gc::norm(node.weightedCenter - x)) {
+        if (node.weight != 0)
+          far(node.weightedCenter, node.weight);
+      } else if (node.firstChild == INVALID_IND) {
+        for (std::size_t k = node.begin; k < node.end; ++k)
+          near(vertices[k]);
+      } else {
+        for (std::size_t c = 0; c < node.nChildren; ++c)
+          stack[nStack++] = node.firstChild + c;
+      }
+    }
+  }
+
+private:
+  /// Subdivide the node, recursively
+  void subdivide(std::size_t nodeInd, std::size_t depth,
+                 const gcs::VertexData<gc::Vector3> &positions,
+                 const gcs::VertexData<double> &weights);
+};
+
+} // namespace solver
+} // namespace mem3dg
@@ -136,6 +136,25 @@ struct Parameters {
     std::size_t n = 1;
     // period factor of computation
     double p = 0;
+    /// cutoff distance of the pairwise penalty found by spatial hashing, 0
+    /// to evaluate all vertex pairs
+    double cutoff = 0;
+    /// skin distance of the Verlet pair list, which is kept until a vertex
+    /// moves by more than half the skin. Requires a cutoff
+    double skin = 0;
+    /// opening angle of the Barnes-Hut tree code, 0 to evaluate all vertex
+    /// pairs exactly. Nodes within the n-ring exclusion radius are always
+    /// opened
+    double theta = 0;
+    /// whether the penalty acts between the nearest vertex-face and edge-edge
+    /// primitives found by the face BVH instead of vertex pairs. Requires a
+    /// cutoff
+    bool isFaceContact = false;
+
+    /**
+     * @brief check parameter conflicts
+     */
+    void checkParameters();
   };
 
   struct External {
@@ -179,6 +198,14 @@ struct Parameters {
     EigenVectorX1d pt = Eigen::MatrixXd::Constant(1, 1, 0);
     /// Whether floating "the" vertex
     bool isFloatVertex = false;
+    /// vertex drift, relative to the mean edge length, up to which the
+    /// factorization of the geodesic solver is reused, 0 to refactorize at
+    /// every geodesic update
+    double geodesicTolerance = 0;
+    /// radius of the local (fast marching) geodesic update of the
+    /// simulation, beyond which the distance is clamped, 0 for the global
+    /// heat method. Has to exceed the radii of the protein0 profile
+    double geodesicRadius = 0;
 
     /**
      * @brief check parameter conflicts
@@ -0,0 +1,217 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <geometrycentral/utilities/vector3.h>
+
+#include "mem3dg/macros.h"
+
+namespace gc = ::geometrycentral;
+
+namespace mem3dg {
+
+namespace solver {
+
+namespace simd {
+
+/// Instruction set of the vectorized halfedge kernels
+enum class InstructionSet { Scalar = 0, AVX2 = 1, AVX512 = 2 };
+
+/**
+ * @brief Find the widest instruction set supported by both the build and the
+ * running CPU
+ */
+DLL_PUBLIC InstructionSet detectInstructionSet();
+
+/**
+ * @brief Name of the instruction set
+ */
+DLL_PUBLIC std::string toString(InstructionSet instructionSet);
+
+/**
+ * @brief Structure of arrays of 3D vectors
+ */
+struct Vector3SoA {
+  /// x component
+  std::vector<double> x;
+  /// y component
+  std::vector<double> y;
+  /// z component
+  std::vector<double> z;
+
+  void resize(std::size_t n) {
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+  }
+  std::size_t size() const { return x.size(); }
+
+  double *data(int component) {
+    return component == 0 ? x.data() : (component == 1 ? y.data() : z.data());
+  }
+  const double *data(int component) const {
+    return component == 0 ? x.data() : (component == 1 ? y.data() : z.data());
+  }
+
+  void set(std::size_t k, const gc::Vector3 &vector) {
+    x[k] = vector.x;
+    y[k] = vector.y;
+    z[k] = vector.z;
+  }
+  gc::Vector3 get(std::size_t k) const {
+    return gc::Vector3{x[k], y[k], z[k]};
+  }
+};
+
+/// Number of halfedges of a BendingBatch block, a multiple of the widest
+/// vector length small enough for the block to stay in the L1/L2 cache
+constexpr std::size_t BATCH_SIZE = 64;
+
+/**
+ * @brief Block of halfedges (in SoA form) of the vectorized bending and
+ * deviatoric kernel, in the outgoing (CSR) order of Connectivity. The
+ * geometry stage turns the gathered edge vectors, face normals and cotan
+ * coefficients into the variational vectors, and the bending stage weights
+ * them with the vertexwise coefficients of computeMechanicalForces, e.g.
+ * schlafliWeight1 = Kbi * (Hi - H0i), into the halfedge contributions to the
+ * vertex forces of the tail. Missing faces and boundary edges of open meshes
+ * are gathered as zero normals, areas and coefficients
+ */
+struct BendingBatch {
+  /// Input: normal of the face of the halfedge
+  Vector3SoA faceNormal;
+  /// Input: normal of the face of the twin halfedge
+  Vector3SoA twinFaceNormal;
+  /// Input: vector of the halfedge
+  Vector3SoA edgeVec;
+  /// Input: vector of the next halfedge
+  Vector3SoA nextEdgeVec;
+  /// Input: vector of the next next halfedge
+  Vector3SoA nextNextEdgeVec;
+  /// Input: vector of the next next halfedge of the twin
+  Vector3SoA twinNextNextEdgeVec;
+  /// Input: area of the face of the halfedge
+  std::vector<double> faceArea;
+  /// Input: dihedral angle of the edge
+  std::vector<double> dihedralAngle;
+  /// Input: cot of he.next().next(), face normal coefficient of the
+  /// dihedral angle gradient wrt the tail
+  std::vector<double> tailCotan;
+  /// Input: cot of he.twin().next(), twin face normal coefficient of the
+  /// dihedral angle gradient wrt the tail
+  std::vector<double> twinTailCotan;
+  /// Input: -(cot of he.next().next() + cot of he.next()), face normal
+  /// coefficient of the dihedral angle gradient wrt the opposite vertex
+  std::vector<double> oppositeCotan;
+  /// Input: oppositeCotan of he.next()
+  std::vector<double> nextOppositeCotan;
+  /// Input: oppositeCotan of he.twin().next().next()
+  std::vector<double> twinOppositeCotan;
+
+  /// Kbi * (Hi - H0i)
+  std::vector<double> schlafliWeight1;
+  /// Kbj * (Hj - H0j)
+  std::vector<double> schlafliWeight2;
+  /// Kbi * (H0i^2 - Hi^2) / 3 + Kbj * (H0j^2 - Hj^2) * 2 / 3
+  std::vector<double> areaGradWeight;
+  /// Kbi * (Hi - H0i) + Kbj * (Hj - H0j)
+  std::vector<double> gaussWeight;
+  /// Kdi * Hi + Kdj * Hj
+  std::vector<double> deviatoricGaussWeight;
+  /// Kdi * (-Hi^2) / 3 + Kdj * (-Hj^2) * 2 / 3
+  std::vector<double> deviatoricAreaGradWeight;
+  /// Kdi * Hi
+  std::vector<double> deviatoricSchlafliWeight1;
+  /// Kdj * Hj
+  std::vector<double> deviatoricSchlafliWeight2;
+
+  /// Geometry: area gradient
+  Vector3SoA areaGrad;
+  /// Geometry: volume variation vector
+  Vector3SoA volumeVariation;
+  /// Geometry: Gaussian curvature vector
+  Vector3SoA gaussVec;
+  /// Geometry: Schlafli vector wrt the dihedral angle at the tail, i.e. the
+  /// edge-length weighted dihedral angle gradient wrt the tail
+  Vector3SoA schlafliVec1;
+  /// Geometry: Schlafli vector wrt the dihedral angles at the tip
+  Vector3SoA schlafliVec2;
+  /// Geometry: edge-length weighted dihedral angle gradient wrt the opposite
+  /// vertex
+  Vector3SoA dihedralOpposite;
+  /// Geometry: corner angle gradient wrt the corner vertex
+  Vector3SoA cornerAngleGradientSelf;
+  /// Geometry: corner angle gradient wrt the tip
+  Vector3SoA cornerAngleGradientTip;
+  /// Geometry: corner angle gradient wrt the opposite vertex
+  Vector3SoA cornerAngleGradientOpposite;
+
+  /// Output: Schlafli component of the bending force
+  Vector3SoA schlafliTerm;
+  /// Output: area gradient component of the bending force
+  Vector3SoA areaGradTerm;
+  /// Output: Gaussian curvature vector component of the bending force
+  Vector3SoA gaussTerm;
+  /// Output: mean curvature component of the deviatoric force
+  Vector3SoA deviatoricMeanTerm;
+
+  void resize(std::size_t n);
+  std::size_t size() const { return gaussWeight.size(); }
+};
+
+/**
+ * @brief Halfedge contributions of the bending stage to the vertex forces of
+ * the tail, gathered by the vertexwise force kernel
+ */
+struct BendingTerms {
+  /// Schlafli component of the bending force
+  gc::Vector3 schlafli;
+  /// Area gradient component of the bending force
+  gc::Vector3 areaGrad;
+  /// Gaussian curvature vector component of the bending force
+  gc::Vector3 gauss;
+  /// Mean curvature component of the deviatoric force
+  gc::Vector3 deviatoricMean;
+};
+
+/**
+ * @brief Evaluate the geometry stage on halfedges [begin, end) of the batch.
+ * The cross products, norms and normalizations are vectorized across
+ * halfedges
+ *
+ * @param instructionSet  instruction set, falls back to scalar if unsupported
+ * @param isCornerAngle   whether to evaluate the corner angle gradients of
+ * the deviatoric force. Exterior halfedges give non-finite values, to be
+ * discarded by the caller
+ */
+DLL_PUBLIC void computeGeometryBatch(InstructionSet instructionSet,
+                                     BendingBatch &batch, std::size_t begin,
+                                     std::size_t end, bool isCornerAngle);
+
+/**
+ * @brief Evaluate the bending stage on halfedges [begin, end) of the batch
+ *
+ * @param instructionSet  instruction set, falls back to scalar if unsupported
+ */
+DLL_PUBLIC void computeBendingBatch(InstructionSet instructionSet,
+                                    BendingBatch &batch, std::size_t begin,
+                                    std::size_t end);
+
+} // namespace simd
+} // namespace solver
+} // namespace mem3dg
@@ -0,0 +1,90 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include <geometrycentral/surface/surface_mesh.h>
+#include <geometrycentral/utilities/vector3.h>
+
+#include "mem3dg/macros.h"
+
+namespace gc = ::geometrycentral;
+namespace gcs = ::geometrycentral::surface;
+
+namespace mem3dg {
+
+namespace solver {
+
+/**
+ * @brief Uniform grid broad phase for vertex proximity queries. Vertices are
+ * binned into cubic cells of the cell size, and the cells are hashed into
+ * buckets stored in CSR form, so that a vertex only meets the vertices in the
+ * 27 surrounding cells. Build and query are O(N) for a bounded number of
+ * vertices per cell.
+ */
+class DLL_PUBLIC SpatialHash {
+public:
+  /// Vertex pair (i, j), i < j
+  using Pair = std::pair<std::size_t, std::size_t>;
+
+  /**
+   * @brief Bin the vertices
+   *
+   * @param positions   vertex positions
+   * @param size        edge length of the cubic cell, no less than the
+   * cutoff of the later queries
+   */
+  void build(const gcs::VertexData<gc::Vector3> &positions, double size);
+
+  /**
+   * @brief Find all vertex pairs closer than the cutoff
+   *
+   * @param positions   vertex positions used in build
+   * @param cutoff      cutoff distance, <= cellSize
+   * @param pairs       pairs (i, j), i < j, sorted by i then j
+   */
+  void findPairs(const gcs::VertexData<gc::Vector3> &positions, double cutoff,
+                 std::vector<Pair> &pairs) const;
+
+  /// Number of vertices at the time of build
+  std::size_t nVertices() const { return vertexCells.size(); }
+  /// Edge length of the cubic cell
+  double getCellSize() const { return cellSize; }
+
+private:
+  /// Edge length of the cubic cell
+  double cellSize = 0;
+  /// Number of buckets, power of two
+  std::size_t nBuckets = 0;
+  /// CSR row offsets into bucketVertices, nBuckets + 1
+  std::vector<std::size_t> bucketOffsets;
+  /// CSR column of vertices of each bucket, in ascending order
+  std::vector<std::size_t> bucketVertices;
+  /// Integer cell coordinates of the vertices
+  std::vector<std::array<std::int64_t, 3>> vertexCells;
+
+  /// Integer cell coordinate of a position component
+  std::int64_t cellIndex(double x) const;
+  /// Bucket of a cell
+  std::size_t bucket(std::int64_t ix, std::int64_t iy, std::int64_t iz) const;
+};
+
+} // namespace solver
+} // namespace mem3dg
@@ -32,7 +32,10 @@
 #include <random>
 
 #include <functional>
+#include <map>
 #include <math.h>
+#include <string>
+#include <tuple>
 #include <vector>
 
 #include "geometrycentral/surface/halfedge_element_types.h"
@@ -44,9 +47,18 @@
 #include "mem3dg/macros.h"
 #include "mem3dg/mesh_io.h"
 #include "mem3dg/meshops.h"
+#include "mem3dg/parallel.h"
+#include "mem3dg/solver/bvh.h"
+#include "mem3dg/solver/connectivity.h"
+#include "mem3dg/solver/cotan_laplacian.h"
 #include "mem3dg/solver/forces.h"
+#include "mem3dg/solver/geodesic.h"
 #include "mem3dg/solver/mesh_process.h"
+#include "mem3dg/solver/octree.h"
 #include "mem3dg/solver/parameters.h"
+#include "mem3dg/solver/simd.h"
+#include "mem3dg/solver/spatial_hash.h"
+#include "mem3dg/solver/variational_vectors.h"
 #include "mem3dg/type_utilities.h"
 
 namespace gc = ::geometrycentral;
@@ -94,8 +106,63 @@ protected:
   /// Random number engine
   pcg32 rng;
   std::normal_distribution<double> normal_dist;
+  /// whether the vertex sweep of computeMechanicalForces also fills
+  /// vertexEnergies, set by computePhysicalForcingAndEnergy
+  bool isVertexEnergySweep;
+  /// whether the vertex kernel of computeMechanicalForces gathers the bending
+  /// and deviatoric mean curvature terms from bendingTerms, set by
+  /// computeMechanicalForces
+  bool isBendingTermsCurrent;
+  /// Area vectors (twice the area times the normal) of the faces at the trial
+  /// positions of computeTrialPotentialEnergy
+  std::vector<gc::Vector3> trialFaceAreaVectors;
+  /// Vertexwise bending, deviatoric, adsorption (per unit epsilon),
+  /// aggregation (per unit chi) and Dirichlet energy, face area and signed
+  /// volume at the trial positions, the faces are attributed to the tail of
+  /// their canonical halfedge
+  Eigen::Matrix<double, Eigen::Dynamic, 7> trialVertexTerms;
+  /// whether the self-avoidance exclusion lists match the mesh topology,
+  /// invalidated by mesh mutation
+  bool isSelfAvoidanceExclusionsCurrent;
+  /// neighborhood layers of the self-avoidance exclusion lists
+  std::size_t selfAvoidanceExclusionLayers;
+  /// whether the self-avoidance Verlet list matches the mesh topology,
+  /// invalidated by mesh mutation
+  bool isSelfAvoidanceVerletListCurrent;
+  /// vertex positions at the last build of the self-avoidance Verlet list
+  EigenVectorX3dr selfAvoidanceVerletPositions;
+  /// cutoff + skin of the self-avoidance Verlet list
+  double selfAvoidanceVerletRange;
+  /// whether the face BVH matches the mesh topology, invalidated by mesh
+  /// mutation
+  bool isFaceBVHCurrent;
+  /// whether the DEC operators and lumped mass matrix of vpg match the current
+  /// geometry, false after a selective refresh or a local update of the
+  /// mutated configuration
+  bool isGeometryOperatorsCurrent;
+  /// whether the sparsity pattern of cotanLaplacian matches the mesh
+  /// topology, invalidated by mesh mutation
+  bool isCotanLaplacianPatternCurrent;
+  /// whether the symbolic analysis of geodesicSolver matches the mesh
+  /// topology, invalidated by mesh mutation
+  bool isGeodesicSolverCurrent;
+  /// whether volume and surfaceArea were computed by the fused geometry
+  /// sweep, consumed by the next updateGlobalQuantities
+  bool isGlobalGeometryCurrent;
 
 public:
+  /// Bitflags of the optional terms of the mechanical forces
+  enum ForceTerm : unsigned {
+    BENDING = 1 << 0,
+    DEVIATORIC = 1 << 1,
+    ADSORPTION = 1 << 2,
+    AGGREGATION = 1 << 3,
+    LINE_TENSION = 1 << 4,
+    ALL_FORCE_TERMS = (1 << 5) - 1
+  };
+  /// Vertexwise mechanical force kernel
+  using MechanicalForcesKernel = void (System::*)(std::size_t);
+
   /// Parameters
   Parameters parameters;
   /// Mesh processor
@@ -107,11 +174,48 @@ public:
   std::unique_ptr<gcs::VertexPositionGeometry> vpg;
   /// Energy
   Energy energy;
+  /// Potential energy of the last computeTrialPotentialEnergy
+  Energy trialEnergy;
   /// Time
   double time;
 
   /// Forces of the system
   Forces forces;
+  /// Cached geometric derivatives for force assembly
+  VariationalVectors variationalVectors;
+  /// Flat connectivity snapshot, rebuilt after topological mutation
+  Connectivity connectivity;
+  /// Halfedge blocks of the vectorized bending kernel, one per thread
+  std::vector<simd::BendingBatch> bendingBatches;
+  /// Halfedge contributions (in outgoing order) of the vectorized bending
+  /// kernel to the vertex forces
+  std::vector<simd::BendingTerms> bendingTerms;
+  /// Vertexwise bending, deviatoric, adsorption (per unit epsilon),
+  /// aggregation (per unit chi) and Dirichlet energy of the fused sweep
+  Eigen::Matrix<double, Eigen::Dynamic, 5> vertexEnergies;
+  /// Broad phase of the self-avoidance penalty
+  SpatialHash spatialHash;
+  /// Vertex pairs of the self-avoidance penalty within the cutoff, excluding
+  /// the neighborhood layers
+  std::vector<SpatialHash::Pair> selfAvoidancePairs;
+  /// Verlet list, vertex pairs within cutoff + skin at the last build
+  std::vector<SpatialHash::Pair> selfAvoidanceVerletPairs;
+  /// Tree code of the self-avoidance penalty, weighted by protein density
+  Octree octree;
+  /// Face BVH of the self-contact penalty, refit at every evaluation
+  FaceBVH faceBVH;
+  /// Vertex-face and edge-edge proximities within the cutoff
+  std::vector<Proximity> selfContacts;
+  /// Cotan Laplacian of the diffusion potential, values updated in place
+  /// between mesh mutations
+  CotanLaplacian cotanLaplacian;
+  /// Heat method solver of the geodesic distance from "the point"
+  GeodesicSolver geodesicSolver;
+  /// CSR row offsets into selfAvoidanceExclusions, nVertices + 1
+  std::vector<std::size_t> selfAvoidanceExclusionOffsets;
+  /// Vertices j > i within the neighborhood layers of vertex i in ascending
+  /// order, which are excluded from the self-avoidance penalty
+  std::vector<std::size_t> selfAvoidanceExclusions;
 
   /// mechanical error norm
   double mechErrorNorm;
@@ -147,6 +251,35 @@ public:
   gcs::VertexData<bool> thePointTracker;
   /// projected time of collision
   double projectedCollideTime;
+  /// number of builds of the self-avoidance Verlet list, to tune the skin
+  std::size_t selfAvoidanceRebuildCount;
+  /// number of threads of the threaded kernels, 0 for the OpenMP default
+  std::size_t nThreads;
+  /// instruction set of the vectorized kernels, default to the widest one
+  simd::InstructionSet instructionSet;
+  /// bitmask of ForceTerm evaluated by computeMechanicalForces
+  unsigned activeForceTerms;
+  /// whether to store the decomposed force components every step. If not
+  /// (lean mode), only mechanicalForceVec is updated and the components are
+  /// computed at save points or by computeDecomposedForces
+  bool isDecomposeForces;
+  /// whether the mechanical forces are up to date after
+  /// updateMutatedConfigurations, consumed by the next computePhysicalForcing
+  bool isMechanicalForcesCurrent;
+  /// whether the last updateMutatedConfigurations recomputed the mechanical
+  /// forces only around the mutation
+  bool isMutatedForcesLocal;
+  /// whether updateConfigurations refreshes only the geometric quantities
+  /// used by the force, energy and mutation code, in one fused sweep, instead
+  /// of vpg->refreshQuantities(). The sparse operators of vpg, i.e. the cotan
+  /// Laplacian, DEC operators and lumped mass matrix, are assembled only by
+  /// refreshGeometry(true)
+  bool isSelectiveRefresh;
+  /// cumulative wall time (s) of refreshGeometry per stage, "all" for
+  /// vpg->refreshQuantities() and "fusedSweep" for computeGeometrySweep(),
+  /// split into its "fusedSweep/faces", "fusedSweep/edges" and
+  /// "fusedSweep/vertices" phases
+  std::map<std::string, double> refreshTimings;
 
   // ==========================================================
   // =============        Constructors           ==============
@@ -479,7 +612,7 @@ private:
   System(std::unique_ptr<gcs::ManifoldSurfaceMesh> ptrmesh_,
          std::unique_ptr<gcs::VertexPositionGeometry> ptrvpg_)
       : mesh(std::move(ptrmesh_)), vpg(std::move(ptrvpg_)),
-        forces(*mesh, *vpg) {
+        forces(*mesh, *vpg), variationalVectors(*mesh) {
 
     time = 0;
     energy = Energy({time, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0});
@@ -495,6 +628,25 @@ private:
     geodesicDistanceFromPtInd = gcs::VertexData<double>(*mesh, 0);
 
     isSmooth = true;
+    nThreads = 0;
+    instructionSet = simd::detectInstructionSet();
+    activeForceTerms = ALL_FORCE_TERMS;
+    isDecomposeForces = true;
+    isVertexEnergySweep = false;
+    isBendingTermsCurrent = false;
+    isMechanicalForcesCurrent = false;
+    isMutatedForcesLocal = false;
+    isSelfAvoidanceExclusionsCurrent = false;
+    selfAvoidanceExclusionLayers = 0;
+    isSelfAvoidanceVerletListCurrent = false;
+    selfAvoidanceVerletRange = 0;
+    isFaceBVHCurrent = false;
+    isGeometryOperatorsCurrent = true;
+    isCotanLaplacianPatternCurrent = false;
+    isGeodesicSolverCurrent = false;
+    isGlobalGeometryCurrent = false;
+    isSelectiveRefresh = false;
+    selfAvoidanceRebuildCount = 0;
     mutationMarker = gc::VertexData<bool>(*mesh, false);
     thePointTracker = gc::VertexData<bool>(*mesh, false);
 
@@ -517,6 +669,8 @@ private:
     vpg->requireHalfedgeCotanWeights();
     vpg->requireEdgeCotanWeights();
     // vpg->requireVertexTangentBasis();
+
+    connectivity.build(*mesh);
   }
 
 public:
@@ -632,6 +786,63 @@ public:
    */
   void updateConfigurations(bool isUpdateGeodesics = false);
 
+  /**
+   * @brief Refresh the cached geometric quantities of vpg, either all of them
+   * by vpg->refreshQuantities() or, if isSelectiveRefresh, only the face,
+   * edge, corner and vertex quantities used in the force, energy and mutation
+   * code by computeGeometrySweep(). The cached cotanLaplacian is updated if
+   * dirichlet.eta != 0. The wall time is accumulated in refreshTimings
+   *
+   * @param isRefreshOperators   whether the sparse operators of vpg are
+   * needed, which forces a full refresh
+   */
+  void refreshGeometry(bool isRefreshOperators = false);
+
+  /**
+   * @brief Compute the face areas and normals, corner angles, halfedge and
+   * edge cotan weights, edge lengths and dihedral angles, vertex dual areas,
+   * mean and Gaussian curvatures and normals of vpg, as well as volume and
+   * surfaceArea, from vpg->inputVertexPositions in one parallel sweep of
+   * face, edge and vertex phases over the connectivity snapshot. The wall
+   * time of each phase is accumulated in refreshTimings
+   */
+  void computeGeometrySweep();
+
+  /**
+   * @brief Update the values of cotanLaplacian from the edge cotan weights,
+   * the sparsity pattern is rebuilt only after mesh mutation
+   */
+  void updateCotanLaplacian();
+
+  /**
+   * @brief Update geodesicDistanceFromPtInd from "the point" by
+   * geodesicSolver, whose factorization is reused within
+   * point.geodesicTolerance
+   *
+   * @param isLocal   whether to use fast marching up to point.geodesicRadius
+   * instead, if it is nonzero
+   */
+  void updateGeodesicDistance(bool isLocal = false);
+
+  /**
+   * @brief Incremental counterpart of updateConfigurations(false) after
+   * mutateMesh. The cached geometry and variational vectors are refreshed on
+   * the vertices of mutationMarker and their 1-ring, and the mechanical forces
+   * on the 2-ring, cached values are reused elsewhere. The capillary and
+   * osmotic forces elsewhere are rescaled from the cached area and volume
+   * gradients if the tension or pressure changes. Falls back to
+   * updateConfigurations(false) if the change is not tracked by
+   * mutationMarker (vertex shift) or the global operators are needed
+   * @return whether the incremental update is applied
+   */
+  bool updateMutatedConfigurations();
+
+  /**
+   * @brief Update surface area, volume and the resulting global surface
+   * tension and osmotic pressure
+   */
+  void updateGlobalQuantities();
+
   // ==========================================================
   // ================   Variational vectors  ==================
   // ==========================================================
@@ -692,6 +903,49 @@ public:
   computeHalfedgeSchlafliVector(gcs::VertexPositionGeometry &vpg,
                                 gc::Halfedge &he);
 
+  /**
+   * @brief Precompute the per-halfedge and per-vertex geometric derivatives
+   * used by the vertexwise force assembly
+   * @param forceTerms  bitmask of ForceTerm whose derivatives are needed
+   */
+  void computeVariationalVectors(unsigned forceTerms = ALL_FORCE_TERMS);
+  /**
+   * @brief Halfedge entries of computeVariationalVectors. The closed mesh
+   * version (IsOpenMesh = false) drops all boundary and interior checks
+   */
+  template <bool IsOpenMesh>
+  void computeHalfedgeVariationalVectors(std::size_t k, unsigned forceTerms);
+
+  /**
+   * @brief Vectorized counterpart of computeVariationalVectors, used by
+   * computeMechanicalForces unless instructionSet is scalar. The outgoing
+   * halfedges are processed in blocks of simd::BendingBatch, whose geometry
+   * stage fills the variational vectors and, with bending or deviatoric
+   * terms, whose bending stage fills bendingTerms
+   * @param forceTerms  bitmask of ForceTerm whose derivatives are needed
+   */
+  void computeBatchedVariationalVectors(unsigned forceTerms);
+  /**
+   * @brief Gather n outgoing halfedges from begin on into the batch. The
+   * closed mesh version (IsOpenMesh = false) drops all boundary and interior
+   * checks
+   */
+  template <bool IsOpenMesh>
+  void gatherBendingBatch(simd::BendingBatch &batch, std::size_t begin,
+                          std::size_t n, bool isCurvature);
+  /**
+   * @brief Line tension entries of computeVariationalVectors on an interior
+   * halfedge
+   */
+  void computeHalfedgeLineTensionVectors(gcs::Halfedge he);
+
+  /**
+   * @brief Local computeVariationalVectors on the given vertices and halfedges
+   */
+  void computeVariationalVectors(const std::vector<std::size_t> &vertices,
+                                 const std::vector<std::size_t> &halfedges,
+                                 unsigned forceTerms);
+
   /**
    * @brief Helper functions to compute geometric derivatives
    */
@@ -707,22 +961,108 @@ public:
   void computePhysicalForcing();
   void computePhysicalForcing(double timeStep);
 
+  /**
+   * @brief Compute all forcing and the total energy of the system, where the
+   * vertexwise energies are accumulated in the same sweep as the mechanical
+   * forces. Equivalent to computePhysicalForcing followed by
+   * computeTotalEnergy, hence external work needs to be updated beforehand
+   * @return forces and energy of the system
+   */
+  std::tuple<const Forces &, const Energy &>
+  computePhysicalForcingAndEnergy(double timeStep = 0);
+
+  /**
+   * @brief Compute the decomposed mechanical force components (and their
+   * normal projections) without changing mechanicalForceVec, for lean mode
+   */
+  void computeDecomposedForces();
+
   /**
    * @brief Compute chemical potential of the system
    */
   void computeChemicalPotentials();
 
   /**
-   * @brief Compute Self Avoidance force
+   * @brief Compute Self Avoidance force. With a cutoff, only the pairs found
+   * by findSelfAvoidancePairs are evaluated, or the proximities found by
+   * findSelfContacts for face contact. With an opening angle theta, far
+   * vertices are approximated by the octree monopoles. Otherwise all vertex
+   * pairs are evaluated
    */
   void computeSelfAvoidanceForce();
 
   /**
-   * @brief Compute mechanical forces
+   * @brief Find selfAvoidancePairs within the cutoff from the Verlet list,
+   * which is rebuilt by spatial hashing after mesh mutation or once a vertex
+   * has moved by more than half the skin
+   */
+  void findSelfAvoidancePairs();
+
+  /**
+   * @brief Refit the face BVH (rebuild after mesh mutation) and find the
+   * vertex-face and edge-edge selfContacts within the cutoff, excluding the
+   * neighborhood layers. Each pair of closest features (vertex, edge or face)
+   * is kept once
+   */
+  void findSelfContacts();
+
+  /**
+   * @brief Rebuild the self-avoidance exclusion lists if the topology or the
+   * number of neighborhood layers has changed
+   */
+  void updateSelfAvoidanceExclusions();
+
+  /**
+   * @brief Whether the pair is excluded from the self-avoidance penalty,
+   * requires up to date exclusion lists
+   */
+  bool isSelfAvoidanceExcluded(std::size_t i, std::size_t j) const;
+
+  /**
+   * @brief Radius around a vertex that contains its excluded neighborhood
+   * layers and the offset distance d, bounded by the number of layers times
+   * the longest edge. Tree code nodes reaching into it are opened
+   */
+  double computeSelfAvoidanceExclusionRadius() const;
+
+  /**
+   * @brief Compute mechanical forces. The vertexwise version gathers from the
+   * cached variational vectors, which need to be up to date
    */
   void computeMechanicalForces();
   void computeMechanicalForces(size_t i);
   void computeMechanicalForces(gcs::Vertex &v);
+  void computeMechanicalForces(const std::vector<std::size_t> &vertices);
+
+  /**
+   * @brief Vertexwise mechanical forces specialized on a bitmask of ForceTerm,
+   * inactive terms are skipped and left zero. The closed mesh version
+   * (IsOpenMesh = false) drops all boundary and interior checks
+   */
+  template <unsigned ForceTerms, bool IsOpenMesh>
+  void computeMechanicalForcesKernel(std::size_t i);
+
+  /**
+   * @brief Specialized kernel of the active force terms and the mesh topology
+   */
+  MechanicalForcesKernel getMechanicalForcesKernel() const;
+
+  /**
+   * @brief Select the active force terms from the parameters. Called at
+   * construction, integrator start and by (mutated) configuration updates,
+   * call again after changing parameters without updating configurations
+   */
+  void updateActiveForceTerms();
+
+  /**
+   * @brief Compute the bending force (and its components) and the mean
+   * curvature component of the deviatoric force with the vectorized halfedge
+   * kernel of computeBatchedVariationalVectors, for the bending-only paths
+   * such as smoothenMesh. Equivalent to the same fields of
+   * computeMechanicalForces, which gathers the same halfedge terms unless
+   * instructionSet is scalar
+   */
+  void computeVectorizedBendingForces();
 
   /**
    * @brief Compute external force component of the system
@@ -782,10 +1122,57 @@ public:
   void computeDirichletEnergy();
 
   /**
-   * @brief Compute self-avoidance energy
+   * @brief Compute self-avoidance energy and projectedCollideTime, from the
+   * same pairs as computeSelfAvoidanceForce. For the tree code, only the near
+   * field pairs project collision
    */
   void computeSelfAvoidanceEnergy();
 
+  /**
+   * @brief Vertexwise energies at vertex i into vertexEnergies, the faces
+   * are attributed to the tail of their canonical halfedge
+   */
+  void computeVertexEnergies(std::size_t i);
+
+  /**
+   * @brief Whether computeTrialPotentialEnergy covers all of the active energy
+   * terms. The self-avoidance penalty and the external force read the state
+   * of vpg, hence need updateConfigurations
+   */
+  bool isTrialEnergySupported() const;
+
+  /**
+   * @brief Compute the potential energy at trial vertex positions and protein
+   * density into trialEnergy, e.g. for the line search. Only the geometric
+   * quantities of the active energy terms are computed from the trial
+   * positions, without touching vpg, energy or forces
+   *
+   * @return potential energy
+   */
+  double
+  computeTrialPotentialEnergy(const EigenVectorX3dr &trialPositions,
+                              const EigenVectorX1d &trialProteinDensity);
+
+  /**
+   * @brief Surface tension at the surface area
+   */
+  double getSurfaceTension(double area) const;
+
+  /**
+   * @brief Osmotic pressure at the enclosed volume
+   */
+  double getOsmoticPressure(double enclosedVolume) const;
+
+  /**
+   * @brief Surface energy at the surface area and surface tension
+   */
+  double getSurfaceEnergy(double area, double surfaceTension) const;
+
+  /**
+   * @brief Pressure energy at the enclosed volume and osmotic pressure
+   */
+  double getPressureEnergy(double enclosedVolume, double osmoticPressure) const;
+
   /**
    * @brief Compute external work
    */
@@ -806,6 +1193,12 @@ public:
    */
   double computeTotalEnergy();
 
+  /**
+   * @brief Sum up the potential (total) energy from the computed terms
+   */
+  double sumPotentialEnergy();
+  double sumTotalEnergy();
+
   /**
    * @brief Compute the L1 norm of the pressure
    */
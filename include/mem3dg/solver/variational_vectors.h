@@ -0,0 +1,82 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#pragma once
+
+#include <geometrycentral/surface/manifold_surface_mesh.h>
+#include <geometrycentral/surface/surface_mesh.h>
+#include <geometrycentral/utilities/vector3.h>
+
+namespace gc = ::geometrycentral;
+namespace gcs = ::geometrycentral::surface;
+
+namespace mem3dg {
+
+namespace solver {
+
+/**
+ * @brief Per-halfedge and per-vertex geometric derivatives shared by the
+ * vertexwise force assembly. All halfedge quantities are taken with respect
+ * to the tail vertex unless noted otherwise. Filled once per force evaluation
+ * by System::computeVariationalVectors.
+ */
+struct VariationalVectors {
+  /// Cached mesh of interest
+  gcs::ManifoldSurfaceMesh &mesh;
+
+  /// Cached vertex mean curvature, H = vertexMeanCurvatures / vertexDualAreas
+  gcs::VertexData<double> meanCurvature;
+
+  /// Cached halfedge area gradient, twice the mean curvature vector
+  gcs::HalfedgeData<gc::Vector3> areaGradient;
+  /// Cached halfedge Gaussian curvature vector
+  gcs::HalfedgeData<gc::Vector3> gaussianCurvatureVector;
+  /// Cached halfedge volume variation vector
+  gcs::HalfedgeData<gc::Vector3> volumeVariationVector;
+  /// Cached area gradient of the face of the (interior) halfedge
+  gcs::HalfedgeData<gc::Vector3> oneSidedAreaGradient;
+  /// Cached gradient of the squared protein gradient norm over face area
+  gcs::HalfedgeData<gc::Vector3> dirichletVector;
+
+  /// Cached edge-length weighted dihedral angle gradient wrt the tail vertex
+  gcs::HalfedgeData<gc::Vector3> dihedralGradientTail;
+  /// Cached edge-length weighted dihedral angle gradient wrt the vertex
+  /// opposite to the halfedge in its face
+  gcs::HalfedgeData<gc::Vector3> dihedralGradientOpposite;
+
+  /// Cached gradient of the corner angle of the halfedge wrt the corner vertex
+  gcs::HalfedgeData<gc::Vector3> cornerAngleGradientSelf;
+  /// Cached gradient of the corner angle of the halfedge wrt the tip vertex
+  gcs::HalfedgeData<gc::Vector3> cornerAngleGradientTip;
+  /// Cached gradient of the corner angle of the halfedge wrt the vertex
+  /// opposite to the halfedge
+  gcs::HalfedgeData<gc::Vector3> cornerAngleGradientOpposite;
+
+  VariationalVectors(gcs::ManifoldSurfaceMesh &mesh_)
+      : mesh(mesh_), meanCurvature(mesh, 0), areaGradient(mesh, {0, 0, 0}),
+        gaussianCurvatureVector(mesh, {0, 0, 0}),
+        volumeVariationVector(mesh, {0, 0, 0}),
+        oneSidedAreaGradient(mesh, {0, 0, 0}),
+        dirichletVector(mesh, {0, 0, 0}),
+        dihedralGradientTail(mesh, {0, 0, 0}),
+        dihedralGradientOpposite(mesh, {0, 0, 0}),
+        cornerAngleGradientSelf(mesh, {0, 0, 0}),
+        cornerAngleGradientTip(mesh, {0, 0, 0}),
+        cornerAngleGradientOpposite(mesh, {0, 0, 0}) {}
+
+  ~VariationalVectors() {}
+};
+
+} // namespace solver
+} // namespace mem3dg
@@ -221,6 +221,27 @@ PYBIND11_MODULE(_core, pymem3dg) {
                       R"delim(
           Wolfe condition parameter
       )delim");
+  euler.def_readwrite("lineSearch", &Euler::lineSearch,
+                      R"delim(
+          line search algorithm, "backtrack" or "moreThuente"
+      )delim");
+  euler.def_readwrite("c2", &Euler::c2,
+                      R"delim(
+          curvature condition parameter of the More-Thuente line search
+      )delim");
+  euler.def_readonly("nEnergyEvaluations", &Euler::nEnergyEvaluations,
+                     R"delim(
+          number of energy evaluations of the line searches
+      )delim");
+  euler.def_readwrite("isWarmStartStep", &Euler::isWarmStartStep,
+                      R"delim(
+          whether start the backtracking from the last accepted step instead of
+          the characteristic time step, off by default
+      )delim");
+  euler.def_readwrite("stepGrowth", &Euler::stepGrowth,
+                      R"delim(
+          growth factor of the initial step after acceptance at the initial step
+      )delim");
 
   /**
    * @brief methods
@@ -331,6 +352,31 @@ PYBIND11_MODULE(_core, pymem3dg) {
                                   R"delim(
           Wolfe condition parameter
       )delim");
+  conjugategradient.def_readwrite("lineSearch",
+                                  &ConjugateGradient::lineSearch,
+                                  R"delim(
+          line search algorithm, "backtrack" or "moreThuente"
+      )delim");
+  conjugategradient.def_readwrite("c2", &ConjugateGradient::c2,
+                                  R"delim(
+          curvature condition parameter of the More-Thuente line search
+      )delim");
+  conjugategradient.def_readonly("nEnergyEvaluations",
+                                 &ConjugateGradient::nEnergyEvaluations,
+                                 R"delim(
+          number of energy evaluations of the line searches
+      )delim");
+  conjugategradient.def_readwrite("isWarmStartStep",
+                                  &ConjugateGradient::isWarmStartStep,
+                                  R"delim(
+          whether start the backtracking from the last accepted step instead of
+          the characteristic time step, off by default
+      )delim");
+  conjugategradient.def_readwrite("stepGrowth",
+                                  &ConjugateGradient::stepGrowth,
+                                  R"delim(
+          growth factor of the initial step after acceptance at the initial step
+      )delim");
   conjugategradient.def_readwrite("restartPeriod",
                                   &ConjugateGradient::restartPeriod,
                                   R"delim(
@@ -413,6 +459,135 @@ PYBIND11_MODULE(_core, pymem3dg) {
           step for n iterations
       )delim");
 
+  // ==========================================================
+  // =============           L-BFGS             ===============
+  // ==========================================================
+  py::class_<LBFGS> lbfgs(pymem3dg, "LBFGS",
+                          R"delim(
+        limited-memory BFGS optimizer
+    )delim");
+
+  lbfgs.def(py::init<System &, double, double, double, double, std::string>(),
+            py::arg("system"), py::arg("characteristicTimeStep"),
+            py::arg("totalTime"), py::arg("savePeriod"), py::arg("tolerance"),
+            py::arg("outputDirectory"),
+            R"delim(
+        L-BFGS optimizer constructor
+      )delim");
+
+  /**
+   * @brief attributes, integration options
+   */
+  lbfgs.def_readonly("characteristicTimeStep", &LBFGS::characteristicTimeStep,
+                     R"delim(
+          characteristic time step
+      )delim");
+  lbfgs.def_readonly("totalTime", &LBFGS::totalTime,
+                     R"delim(
+          time limit
+      )delim");
+  lbfgs.def_readonly("savePeriod", &LBFGS::savePeriod,
+                     R"delim(
+         period of saving output data
+      )delim");
+  lbfgs.def_readonly("tolerance", &LBFGS::tolerance,
+                     R"delim(
+          tolerance for termination
+      )delim");
+  lbfgs.def_readwrite("trajFileName", &LBFGS::trajFileName,
+                      R"delim(
+          name of the trajectory file 
+      )delim");
+  lbfgs.def_readwrite("isAdaptiveStep", &LBFGS::isAdaptiveStep,
+                      R"delim(
+          option to scale time step according to mesh size
+      )delim");
+  lbfgs.def_readwrite("outputDirectory", &LBFGS::outputDirectory,
+                      R"delim(
+          path to the output directory
+      )delim");
+  lbfgs.def_readwrite("verbosity", &LBFGS::verbosity,
+                      R"delim(
+           verbosity level of integrator
+      )delim");
+  lbfgs.def_readwrite("isJustGeometryPly", &LBFGS::isJustGeometryPly,
+                      R"delim(
+           save .ply with just geometry
+      )delim");
+  lbfgs.def_readwrite("historyLength", &LBFGS::historyLength,
+                      R"delim(
+          number of steps kept in the history
+      )delim");
+  lbfgs.def_readwrite("lineSearch", &LBFGS::lineSearch,
+                      R"delim(
+          line search algorithm, "backtrack" or "moreThuente"
+      )delim");
+  lbfgs.def_readwrite("rho", &LBFGS::rho,
+                      R"delim(
+          backtracking coefficient
+      )delim");
+  lbfgs.def_readwrite("c1", &LBFGS::c1,
+                      R"delim(
+          Wolfe condition parameter
+      )delim");
+  lbfgs.def_readwrite("c2", &LBFGS::c2,
+                      R"delim(
+          curvature condition parameter of the More-Thuente line search
+      )delim");
+  lbfgs.def_readwrite("ctol", &LBFGS::ctol,
+                      R"delim(
+          tolerance for termination (contraints)
+      )delim");
+  lbfgs.def_readwrite("isAugmentedLagrangian", &LBFGS::isAugmentedLagrangian,
+                      R"delim(
+          option to use Augmented Lagrangian method
+      )delim");
+  lbfgs.def_readonly("nEnergyEvaluations", &LBFGS::nEnergyEvaluations,
+                     R"delim(
+          number of energy evaluations of the line searches
+      )delim");
+  lbfgs.def_readwrite("isWarmStartStep", &LBFGS::isWarmStartStep,
+                      R"delim(
+          whether start the backtracking from the last accepted step instead of
+          the characteristic time step, off by default
+      )delim");
+  lbfgs.def_readwrite("stepGrowth", &LBFGS::stepGrowth,
+                      R"delim(
+          growth factor of the initial step after acceptance at the initial step
+      )delim");
+
+  /**
+   * @brief methods
+   */
+  lbfgs.def("integrate", &LBFGS::integrate,
+            R"delim(
+          integrate 
+      )delim");
+  lbfgs.def("status", &LBFGS::status,
+            R"delim(
+          status computation and thresholding
+      )delim");
+  lbfgs.def("march", &LBFGS::march,
+            R"delim(
+          stepping forward 
+      )delim");
+  lbfgs.def("saveData", &LBFGS::saveData,
+            R"delim(
+          save data to output directory
+      )delim");
+  lbfgs.def("step", &LBFGS::step, py::arg("n"),
+            R"delim(
+          step for n iterations
+      )delim");
+  lbfgs.def("clearHistory", &LBFGS::clearHistory,
+            R"delim(
+          clear the history, i.e. restart from the identity inverse Hessian
+      )delim");
+  lbfgs.def("getHistorySize", &LBFGS::getHistorySize,
+            R"delim(
+          get the number of steps in the history
+      )delim");
+
 #pragma endregion integrators
 
 #pragma region forces
@@ -878,6 +1053,27 @@ PYBIND11_MODULE(_core, pymem3dg) {
                        R"delim(
           get the time
       )delim");
+  system.def_readwrite("nThreads", &System::nThreads,
+                       R"delim(
+          get the number of threads of the threaded kernels, 0 for the OpenMP default
+      )delim");
+  system.def_readwrite("isDecomposeForces", &System::isDecomposeForces,
+                       R"delim(
+          get the option of storing decomposed force components every step, otherwise only at save points
+      )delim");
+  system.def_readonly("selfAvoidanceRebuildCount",
+                      &System::selfAvoidanceRebuildCount,
+                      R"delim(
+          get the number of builds of the self-avoidance Verlet pair list
+      )delim");
+  system.def_readwrite("isSelectiveRefresh", &System::isSelectiveRefresh,
+                       R"delim(
+          get the option of refreshing only the geometric quantities used by the solver, instead of all quantities of the geometry
+      )delim");
+  system.def_readonly("refreshTimings", &System::refreshTimings,
+                      R"delim(
+          get the cumulative wall time (s) of the geometry refresh per quantity
+      )delim");
 
   /**
    * @brief    Geometric properties (Geometry central)
@@ -892,13 +1088,22 @@ PYBIND11_MODULE(_core, pymem3dg) {
       )delim");
   system.def(
       "getLumpedMassMatrix",
-      [](System &s) { return s.vpg->vertexLumpedMassMatrix; },
+      [](System &s) {
+        if (!s.isGeometryOperatorsCurrent)
+          s.refreshGeometry(true);
+        return s.vpg->vertexLumpedMassMatrix;
+      },
       py::return_value_policy::copy,
       R"delim(
           get the lumped mass matrix of the mesh
       )delim");
   system.def(
-      "getCotanLaplacian", [](System &s) { return s.vpg->cotanLaplacian; },
+      "getCotanLaplacian",
+      [](System &s) {
+        if (!s.isGeometryOperatorsCurrent)
+          s.refreshGeometry(true);
+        return s.vpg->cotanLaplacian;
+      },
       py::return_value_policy::copy,
       R"delim(
           get the Cotan Laplacian matrix of the mesh
@@ -927,13 +1132,23 @@ PYBIND11_MODULE(_core, pymem3dg) {
           get the face vertex matrix
       )delim");
   system.def(
-      "getVertexAdjacencyMatrix", [](System &s) { return s.vpg->d0; },
+      "getVertexAdjacencyMatrix",
+      [](System &s) {
+        if (!s.isGeometryOperatorsCurrent)
+          s.refreshGeometry(true);
+        return s.vpg->d0;
+      },
       py::return_value_policy::copy,
       R"delim(
           get the signed E-V vertex adjacency matrix, equivalent of d0 operator
       )delim");
   system.def(
-      "getEdgeAdjacencyMatrix", [](System &s) { return s.vpg->d1; },
+      "getEdgeAdjacencyMatrix",
+      [](System &s) {
+        if (!s.isGeometryOperatorsCurrent)
+          s.refreshGeometry(true);
+        return s.vpg->d1;
+      },
       py::return_value_policy::copy,
       R"delim(
           get the signed F-E edge adjacency matrix, equivalent of d1 operator
@@ -1082,6 +1297,14 @@ PYBIND11_MODULE(_core, pymem3dg) {
              R"delim(
             compute the DPDForces
         )delim");
+  system.def("computeDecomposedForces", &System::computeDecomposedForces,
+             R"delim(
+            compute the decomposed force components, needed in lean mode (isDecomposeForces = False)
+        )delim");
+  system.def("updateActiveForceTerms", &System::updateActiveForceTerms,
+             R"delim(
+            select the active terms of the mechanical forces from the parameters, needed after changing parameters
+        )delim");
 
   /**
    * @brief Method: Energy computation
@@ -1090,6 +1313,26 @@ PYBIND11_MODULE(_core, pymem3dg) {
              R"delim(
           compute the total energy, where total energy = kinetic energy + potential energy - external work
       )delim");
+  system.def("computePhysicalForcingAndEnergy",
+             &System::computePhysicalForcingAndEnergy, py::arg("timeStep") = 0,
+             py::return_value_policy::reference_internal,
+             R"delim(
+          compute all the forces and the total energy in a fused sweep, returns (forces, energy)
+      )delim");
+  system.def("computeTrialPotentialEnergy",
+             &System::computeTrialPotentialEnergy, py::arg("trialPositions"),
+             py::arg("trialProteinDensity"),
+             R"delim(
+          compute the potential energy at trial positions and protein density into trialEnergy, without updating the system
+      )delim");
+  system.def("isTrialEnergySupported", &System::isTrialEnergySupported,
+             R"delim(
+          whether computeTrialPotentialEnergy covers the active energy terms
+      )delim");
+  system.def_readonly("trialEnergy", &System::trialEnergy,
+                      R"delim(
+          get the Energy components of the last computeTrialPotentialEnergy
+      )delim");
   system.def(
       "computeIntegratedPower",
       static_cast<double (System::*)(double)>(&System::computeIntegratedPower),
@@ -1112,6 +1355,16 @@ PYBIND11_MODULE(_core, pymem3dg) {
              R"delim(
           update the system configuration due to changes in state variables (e.g vertex positions or protein density)
       )delim");
+  system.def("refreshGeometry", &System::refreshGeometry,
+             py::arg("isRefreshOperators") = false,
+             R"delim(
+          refresh the cached geometric quantities, all of them unless isSelectiveRefresh
+      )delim");
+  system.def("updateMutatedConfigurations",
+             &System::updateMutatedConfigurations,
+             R"delim(
+          incremental update of the system configuration after mutateMesh, limited to the mutated vertices and their neighborhood
+      )delim");
 
   /**
    * @brief Method: I/O
@@ -1336,6 +1589,23 @@ PYBIND11_MODULE(_core, pymem3dg) {
                               R"delim(
           get the period factor of self-avoidance computation
       )delim");
+  selfAvoidance.def_readwrite("cutoff", &Parameters::SelfAvoidance::cutoff,
+                              R"delim(
+          get the cutoff distance of the penalty found by spatial hashing, 0 to evaluate all vertex pairs
+      )delim");
+  selfAvoidance.def_readwrite("skin", &Parameters::SelfAvoidance::skin,
+                              R"delim(
+          get the skin distance of the Verlet pair list, which is rebuilt once a vertex moves by more than half the skin
+      )delim");
+  selfAvoidance.def_readwrite("theta", &Parameters::SelfAvoidance::theta,
+                              R"delim(
+          get the opening angle of the Barnes-Hut tree code, 0 to evaluate all vertex pairs exactly
+      )delim");
+  selfAvoidance.def_readwrite("isFaceContact",
+                              &Parameters::SelfAvoidance::isFaceContact,
+                              R"delim(
+          get the option of penalizing the nearest vertex-face and edge-edge primitives instead of vertex pairs, requires a cutoff
+      )delim");
 
   py::class_<Parameters::Point> point(pymem3dg, "Point",
                                       R"delim(
@@ -1349,6 +1619,15 @@ PYBIND11_MODULE(_core, pymem3dg) {
                       R"delim(
           whether use floating vertex option
       )delim");
+  point.def_readwrite("geodesicTolerance",
+                      &Parameters::Point::geodesicTolerance,
+                      R"delim(
+          get the vertex drift (relative to the mean edge length) up to which the geodesic solver factorization is reused
+      )delim");
+  point.def_readwrite("geodesicRadius", &Parameters::Point::geodesicRadius,
+                      R"delim(
+          get the radius of the local geodesic update, 0 for the global heat method
+      )delim");
 
   py::class_<Parameters::ProteinDistribution> proteindistribution(
       pymem3dg, "ProteinDistribution",
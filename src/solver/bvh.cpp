@@ -0,0 +1,241 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#include "mem3dg/solver/bvh.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "mem3dg/parallel.h"
+
+namespace mem3dg {
+namespace solver {
+
+constexpr std::size_t FaceBVH::INVALID_IND;
+constexpr std::size_t FaceBVH::LEAF_SIZE;
+
+static double component(const gc::Vector3 &x, int axis) {
+  return axis == 0 ? x.x : (axis == 1 ? x.y : x.z);
+}
+
+static gc::Vector3 componentMin(const gc::Vector3 &x, const gc::Vector3 &y) {
+  return {std::min(x.x, y.x), std::min(x.y, y.y), std::min(x.z, y.z)};
+}
+
+static gc::Vector3 componentMax(const gc::Vector3 &x, const gc::Vector3 &y) {
+  return {std::max(x.x, y.x), std::max(x.y, y.y), std::max(x.z, y.z)};
+}
+
+std::array<std::size_t, 6> closestFeatures(const Proximity &proximity) {
+  std::array<std::size_t, 3> first, second;
+  first.fill(std::numeric_limits<std::size_t>::max());
+  second.fill(std::numeric_limits<std::size_t>::max());
+  std::size_t nFirst = 0, nSecond = 0;
+  for (std::size_t k = 0; k < 4; ++k) {
+    if (proximity.coefficients[k] > 0)
+      first[nFirst++] = proximity.vertices[k];
+    else if (proximity.coefficients[k] < 0)
+      second[nSecond++] = proximity.vertices[k];
+  }
+  std::sort(first.begin(), first.end());
+  std::sort(second.begin(), second.end());
+  if (second < first)
+    std::swap(first, second);
+  return {first[0], first[1], first[2], second[0], second[1], second[2]};
+}
+
+// Real-Time Collision Detection (Ericson), 5.1.5
+gc::Vector3 closestPointOnTriangle(const gc::Vector3 &p, const gc::Vector3 &a,
+                                   const gc::Vector3 &b, const gc::Vector3 &c,
+                                   std::array<double, 3> &barycentric) {
+  gc::Vector3 ab = b - a, ac = c - a, ap = p - a;
+  double d1 = gc::dot(ab, ap), d2 = gc::dot(ac, ap);
+  if (d1 <= 0 && d2 <= 0) {
+    barycentric = {1, 0, 0};
+    return a;
+  }
+  gc::Vector3 bp = p - b;
+  double d3 = gc::dot(ab, bp), d4 = gc::dot(ac, bp);
+  if (d3 >= 0 && d4 <= d3) {
+    barycentric = {0, 1, 0};
+    return b;
+  }
+  double vc = d1 * d4 - d3 * d2;
+  if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+    double v = d1 / (d1 - d3);
+    barycentric = {1 - v, v, 0};
+    return a + v * ab;
+  }
+  gc::Vector3 cp = p - c;
+  double d5 = gc::dot(ab, cp), d6 = gc::dot(ac, cp);
+  if (d6 >= 0 && d5 <= d6) {
+    barycentric = {0, 0, 1};
+    return c;
+  }
+  double vb = d5 * d2 - d1 * d6;
+  if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+    double w = d2 / (d2 - d6);
+    barycentric = {1 - w, 0, w};
+    return a + w * ac;
+  }
+  double va = d3 * d6 - d5 * d4;
+  if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) {
+    double w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    barycentric = {0, 1 - w, w};
+    return b + w * (c - b);
+  }
+  double denom = 1 / (va + vb + vc);
+  double v = vb * denom, w = vc * denom;
+  barycentric = {1 - v - w, v, w};
+  return a + v * ab + w * ac;
+}
+
+// Real-Time Collision Detection (Ericson), 5.1.9
+void closestPointsOnSegments(const gc::Vector3 &p1, const gc::Vector3 &q1,
+                             const gc::Vector3 &p2, const gc::Vector3 &q2,
+                             double &s, double &t) {
+  const double eps = 1e-14;
+  auto clamp = [](double x) { return std::min(std::max(x, 0.0), 1.0); };
+  gc::Vector3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+  double a = gc::dot(d1, d1), e = gc::dot(d2, d2), f = gc::dot(d2, r);
+  if (a <= eps && e <= eps) {
+    s = t = 0;
+    return;
+  }
+  if (a <= eps) {
+    s = 0;
+    t = clamp(f / e);
+    return;
+  }
+  double c = gc::dot(d1, r);
+  if (e <= eps) {
+    t = 0;
+    s = clamp(-c / a);
+    return;
+  }
+  double b = gc::dot(d1, d2);
+  double denom = a * e - b * b;
+  s = (denom != 0) ? clamp((b * f - c * e) / denom) : 0;
+  t = (b * s + f) / e;
+  if (t < 0) {
+    t = 0;
+    s = clamp(-c / a);
+  } else if (t > 1) {
+    t = 1;
+    s = clamp((b - c) / a);
+  }
+}
+
+void FaceBVH::build(const Connectivity &cn,
+                    const gcs::VertexData<gc::Vector3> &positions,
+                    std::size_t nThreads) {
+  nodes.clear();
+  levels.clear();
+  faces.resize(cn.nFaces);
+  std::iota(faces.begin(), faces.end(), 0);
+  if (cn.nFaces == 0)
+    return;
+
+  std::vector<gc::Vector3> centroids(cn.nFaces);
+  for (std::size_t f = 0; f < cn.nFaces; ++f) {
+    std::array<std::size_t, 3> v = faceVertices(cn, f);
+    centroids[f] =
+        (positions[v[0]] + positions[v[1]] + positions[v[2]]) / 3.0;
+  }
+
+  Node root;
+  root.left = root.right = INVALID_IND;
+  root.begin = 0;
+  root.end = cn.nFaces;
+  nodes.push_back(root);
+  split(0, 0, centroids);
+  refit(cn, positions, nThreads);
+}
+
+void FaceBVH::split(std::size_t nodeInd, std::size_t depth,
+                    const std::vector<gc::Vector3> &centroids) {
+  if (levels.size() <= depth)
+    levels.resize(depth + 1);
+  levels[depth].push_back(nodeInd);
+  const std::size_t begin = nodes[nodeInd].begin, end = nodes[nodeInd].end;
+  if (end - begin <= LEAF_SIZE)
+    return;
+
+  // longest axis of the centroid bounds
+  gc::Vector3 lower = centroids[faces[begin]], upper = lower;
+  for (std::size_t k = begin + 1; k < end; ++k) {
+    lower = componentMin(lower, centroids[faces[k]]);
+    upper = componentMax(upper, centroids[faces[k]]);
+  }
+  gc::Vector3 extent = upper - lower;
+  int axis = (extent.x >= extent.y && extent.x >= extent.z)
+                 ? 0
+                 : (extent.y >= extent.z ? 1 : 2);
+
+  const std::size_t mid = begin + (end - begin) / 2;
+  std::nth_element(faces.begin() + begin, faces.begin() + mid,
+                   faces.begin() + end, [&](std::size_t f1, std::size_t f2) {
+                     return component(centroids[f1], axis) <
+                            component(centroids[f2], axis);
+                   });
+
+  Node left, right;
+  left.left = left.right = right.left = right.right = INVALID_IND;
+  left.begin = begin;
+  left.end = right.begin = mid;
+  right.end = end;
+  nodes[nodeInd].left = nodes.size();
+  nodes.push_back(left);
+  nodes[nodeInd].right = nodes.size();
+  nodes.push_back(right);
+  split(nodes[nodeInd].left, depth + 1, centroids);
+  split(nodes[nodeInd].right, depth + 1, centroids);
+}
+
+void FaceBVH::refit(const Connectivity &cn,
+                    const gcs::VertexData<gc::Vector3> &positions,
+                    std::size_t nThreads) {
+  if (faces.size() != cn.nFaces)
+    mem3dg_runtime_error("FaceBVH: the mesh topology has changed, rebuild!");
+
+  // children are at the next level, hence refit from the deepest level
+  for (std::size_t d = levels.size(); d-- > 0;) {
+    const std::vector<std::size_t> &level = levels[d];
+    const std::ptrdiff_t nNodes = level.size();
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+    for (std::ptrdiff_t k = 0; k < nNodes; ++k) {
+      Node &node = nodes[level[k]];
+      if (node.left == INVALID_IND) {
+        std::array<std::size_t, 3> v = faceVertices(cn, faces[node.begin]);
+        node.lower = node.upper = positions[v[0]];
+        for (std::size_t n = node.begin; n < node.end; ++n) {
+          for (std::size_t i : faceVertices(cn, faces[n])) {
+            node.lower = componentMin(node.lower, positions[i]);
+            node.upper = componentMax(node.upper, positions[i]);
+          }
+        }
+      } else {
+        node.lower = componentMin(nodes[node.left].lower,
+                                  nodes[node.right].lower);
+        node.upper = componentMax(nodes[node.left].upper,
+                                  nodes[node.right].upper);
+      }
+    }
+  }
+}
+
+} // namespace solver
+} // namespace mem3dg
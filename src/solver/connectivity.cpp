@@ -0,0 +1,112 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#include "mem3dg/solver/connectivity.h"
+
+#include <algorithm>
+
+#include <geometrycentral/surface/halfedge_element_types.h>
+#include <geometrycentral/surface/manifold_surface_mesh.h>
+
+#include "mem3dg/macros.h"
+
+namespace mem3dg {
+namespace solver {
+
+namespace gc = ::geometrycentral;
+namespace gcs = ::geometrycentral::surface;
+
+constexpr std::size_t Connectivity::INVALID_IND;
+
+void Connectivity::build(gcs::ManifoldSurfaceMesh &mesh) {
+  if (!mesh.isCompressed()) {
+    mem3dg_runtime_error("Mesh must be compressed to build connectivity!");
+  }
+
+  nVertices = mesh.nVertices();
+  nHalfedges = mesh.nHalfedges();
+  nEdges = mesh.nEdges();
+  nFaces = mesh.nFaces();
+  hasBoundary = mesh.hasBoundary();
+
+  // vertex to outgoing halfedges
+  outgoingOffsets.assign(nVertices + 1, 0);
+  outgoingHalfedges.clear();
+  outgoingHalfedges.reserve(nHalfedges);
+  vertexIsBoundary.assign(nVertices, 0);
+  for (std::size_t i = 0; i < nVertices; ++i) {
+    gcs::Vertex v{mesh.vertex(i)};
+    vertexIsBoundary[i] = v.isBoundary();
+    for (gcs::Halfedge he : v.outgoingHalfedges()) {
+      outgoingHalfedges.push_back(he.getIndex());
+    }
+    outgoingOffsets[i + 1] = outgoingHalfedges.size();
+  }
+
+  // halfedge adjacency
+  halfedgeTail.resize(nHalfedges);
+  halfedgeTip.resize(nHalfedges);
+  halfedgeNext.resize(nHalfedges);
+  halfedgeTwin.resize(nHalfedges);
+  halfedgeEdge.resize(nHalfedges);
+  halfedgeFace.resize(nHalfedges);
+  halfedgeFlags.assign(nHalfedges, 0);
+  for (std::size_t k = 0; k < nHalfedges; ++k) {
+    gcs::Halfedge he{mesh.halfedge(k)};
+    halfedgeTail[k] = he.tailVertex().getIndex();
+    halfedgeTip[k] = he.tipVertex().getIndex();
+    halfedgeNext[k] = he.next().getIndex();
+    halfedgeTwin[k] = he.twin().getIndex();
+    halfedgeEdge[k] = he.edge().getIndex();
+    if (he.isInterior()) {
+      halfedgeFace[k] = he.face().getIndex();
+      halfedgeFlags[k] |= INTERIOR;
+    } else {
+      halfedgeFace[k] = INVALID_IND;
+    }
+    if (he.edge().isBoundary()) {
+      halfedgeFlags[k] |= BOUNDARY_EDGE;
+    }
+  }
+
+  // canonical halfedges
+  edgeHalfedge.resize(nEdges);
+  for (std::size_t k = 0; k < nEdges; ++k) {
+    edgeHalfedge[k] = mesh.edge(k).halfedge().getIndex();
+  }
+  faceHalfedge.resize(nFaces);
+  for (std::size_t k = 0; k < nFaces; ++k) {
+    faceHalfedge[k] = mesh.face(k).halfedge().getIndex();
+  }
+}
+
+std::vector<std::size_t>
+Connectivity::expandRing(const std::vector<std::size_t> &vertices,
+                         std::vector<std::uint8_t> &vertexMarker) const {
+  std::vector<std::size_t> ring(vertices);
+  for (std::size_t i : vertices) {
+    for (std::size_t k = outgoingOffsets[i]; k < outgoingOffsets[i + 1]; ++k) {
+      std::size_t j = halfedgeTip[outgoingHalfedges[k]];
+      if (!vertexMarker[j]) {
+        vertexMarker[j] = true;
+        ring.push_back(j);
+      }
+    }
+  }
+  std::sort(ring.begin(), ring.end());
+  return ring;
+}
+
+} // namespace solver
+} // namespace mem3dg
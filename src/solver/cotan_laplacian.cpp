@@ -0,0 +1,84 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#include "mem3dg/solver/cotan_laplacian.h"
+
+#include <algorithm>
+
+#include "mem3dg/parallel.h"
+
+namespace mem3dg {
+namespace solver {
+
+void CotanLaplacian::build(const Connectivity &cn) {
+  std::vector<Eigen::Triplet<double>> triplets;
+  triplets.reserve(cn.outgoingHalfedges.size() + cn.nVertices);
+  for (std::size_t i = 0; i < cn.nVertices; ++i) {
+    triplets.emplace_back(i, i, 0);
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k)
+      triplets.emplace_back(cn.halfedgeTip[cn.outgoingHalfedges[k]], i, 0);
+  }
+  matrix.resize(cn.nVertices, cn.nVertices);
+  matrix.setFromTriplets(triplets.begin(), triplets.end());
+  matrix.makeCompressed();
+
+  // row indices of a column are sorted
+  const int *outer = matrix.outerIndexPtr();
+  const int *inner = matrix.innerIndexPtr();
+  auto nonzero = [&](std::size_t row, std::size_t col) -> std::size_t {
+    return std::lower_bound(inner + outer[col], inner + outer[col + 1],
+                            static_cast<int>(row)) -
+           inner;
+  };
+  halfedgeNonzeros.resize(cn.outgoingHalfedges.size());
+  diagonalNonzeros.resize(cn.nVertices);
+  for (std::size_t i = 0; i < cn.nVertices; ++i) {
+    diagonalNonzeros[i] = nonzero(i, i);
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k)
+      halfedgeNonzeros[k] = nonzero(cn.halfedgeTip[cn.outgoingHalfedges[k]], i);
+  }
+}
+
+void CotanLaplacian::update(const Connectivity &cn,
+                            const Eigen::VectorXd &edgeCotanWeights,
+                            std::size_t nThreads) {
+  if (diagonalNonzeros.size() != cn.nVertices ||
+      halfedgeNonzeros.size() != cn.outgoingHalfedges.size())
+    mem3dg_runtime_error(
+        "CotanLaplacian: the mesh topology has changed, rebuild!");
+
+  // every column is written by one thread
+  double *values = matrix.valuePtr();
+  const std::ptrdiff_t nVertices = cn.nVertices;
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+    double diagonal = 0;
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k) {
+      std::size_t e = cn.halfedgeEdge[cn.outgoingHalfedges[k]];
+      double weight = edgeCotanWeights[e];
+      values[halfedgeNonzeros[k]] = -weight;
+      diagonal += weight;
+    }
+    values[diagonalNonzeros[i]] = diagonal;
+  }
+}
+
+} // namespace solver
+} // namespace mem3dg
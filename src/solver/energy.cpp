@@ -11,6 +11,8 @@
 //     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
 //     Padmini Rangamani (prangamani@eng.ucsd.edu)
 //
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 #include <geometrycentral/surface/halfedge_mesh.h>
@@ -26,6 +28,7 @@
 #include "geometrycentral/surface/surface_mesh.h"
 #include "mem3dg/constants.h"
 #include "mem3dg/meshops.h"
+#include "mem3dg/parallel.h"
 #include "mem3dg/solver/system.h"
 #include "mem3dg/type_utilities.h"
 
@@ -49,14 +52,15 @@ void System::computeBendingEnergy() {
   // Eigen::Matrix<double, Eigen::Dynamic, 1> H_difference = H.raw() - H0.raw();
   // E.BE = P.Kb * H_difference.transpose() * M * H_difference;
 
-  Eigen::Matrix<double, Eigen::Dynamic, 1> H_difference =
-      abs(vpg->vertexMeanCurvatures.raw().array() /
-              vpg->vertexDualAreas.raw().array() -
-          H0.raw().array());
-  energy.bendingEnergy =
-      (Kb.raw().array() * vpg->vertexDualAreas.raw().array() *
-       H_difference.array().square())
-          .sum();
+  energy.bendingEnergy = parallelSum(
+      mesh->nVertices(),
+      [this](std::size_t i) {
+        double H_difference = std::abs(vpg->vertexMeanCurvatures[i] /
+                                           vpg->vertexDualAreas[i] -
+                                       H0[i]);
+        return Kb[i] * vpg->vertexDualAreas[i] * (H_difference * H_difference);
+      },
+      nThreads);
 
   // when considering topological changes, additional term of gauss curvature
   // E.BE = P.Kb * H_difference.transpose() * M * H_difference + P.KG * (M *
@@ -64,11 +68,15 @@ void System::computeBendingEnergy() {
 }
 
 void System::computeDeviatoricEnergy() {
-  energy.deviatoricEnergy =
-      (Kd.raw().array() * (vpg->vertexMeanCurvatures.raw().array().square() /
-                               vpg->vertexDualAreas.raw().array() -
-                           vpg->vertexGaussianCurvatures.raw().array()))
-          .sum();
+  energy.deviatoricEnergy = parallelSum(
+      mesh->nVertices(),
+      [this](std::size_t i) {
+        double meanCurvature = vpg->vertexMeanCurvatures[i];
+        double dualArea = vpg->vertexDualAreas[i];
+        return Kd[i] * (meanCurvature * meanCurvature / dualArea -
+                        vpg->vertexGaussianCurvatures[i]);
+      },
+      nThreads);
   // energy.deviatoricEnergy =
   //     (Kd.raw().array() * (vpg->vertexMeanCurvatures.raw().array().square() /
   //                          vpg->vertexDualAreas.raw().array()))
@@ -79,28 +87,37 @@ void System::computeDeviatoricEnergy() {
 }
 
 void System::computeSurfaceEnergy() {
+  energy.surfaceEnergy = getSurfaceEnergy(surfaceArea, forces.surfaceTension);
+}
+
+double System::getSurfaceEnergy(double area, double surfaceTension) const {
   // cotan laplacian normal is exact for area variation
-  double A_difference = surfaceArea - parameters.tension.At;
-  energy.surfaceEnergy =
-      parameters.tension.isConstantSurfaceTension
-          ? forces.surfaceTension * surfaceArea
-          : forces.surfaceTension * A_difference / 2 +
-                parameters.tension.lambdaSG * A_difference / 2;
+  double A_difference = area - parameters.tension.At;
+  return parameters.tension.isConstantSurfaceTension
+             ? surfaceTension * area
+             : surfaceTension * A_difference / 2 +
+                   parameters.tension.lambdaSG * A_difference / 2;
 }
 
 void System::computePressureEnergy() {
+  energy.pressureEnergy = getPressureEnergy(volume, forces.osmoticPressure);
+}
+
+double System::getPressureEnergy(double enclosedVolume,
+                                 double osmoticPressure) const {
   // Note: area weighted normal is exact volume variation
   if (parameters.osmotic.isPreferredVolume) {
-    double V_difference = volume - parameters.osmotic.Vt;
-    energy.pressureEnergy = -forces.osmoticPressure * V_difference / 2 +
-                            parameters.osmotic.lambdaV * V_difference / 2;
+    double V_difference = enclosedVolume - parameters.osmotic.Vt;
+    return -osmoticPressure * V_difference / 2 +
+           parameters.osmotic.lambdaV * V_difference / 2;
   } else if (parameters.osmotic.isConstantOsmoticPressure) {
-    energy.pressureEnergy = -forces.osmoticPressure * volume;
+    return -osmoticPressure * enclosedVolume;
   } else {
-    double ratio = parameters.osmotic.cam * volume / parameters.osmotic.n;
-    energy.pressureEnergy = mem3dg::constants::i * mem3dg::constants::R *
-                            parameters.temperature * parameters.osmotic.n *
-                            (ratio - log(ratio) - 1);
+    double ratio =
+        parameters.osmotic.cam * enclosedVolume / parameters.osmotic.n;
+    return mem3dg::constants::i * mem3dg::constants::R *
+           parameters.temperature * parameters.osmotic.n *
+           (ratio - log(ratio) - 1);
   }
 }
 
@@ -118,56 +135,129 @@ void System::computePressureEnergy() {
 void System::computeAdsorptionEnergy() {
   energy.adsorptionEnergy =
       parameters.adsorption.epsilon *
-      (vpg->vertexDualAreas.raw().array() * proteinDensity.raw().array()).sum();
+      parallelSum(
+          mesh->nVertices(),
+          [this](std::size_t i) {
+            return vpg->vertexDualAreas[i] * proteinDensity[i];
+          },
+          nThreads);
 }
 
 void System::computeAggregationEnergy() {
   energy.aggregationEnergy =
       parameters.aggregation.chi *
-      (vpg->vertexDualAreas.raw().array() * proteinDensity.raw().array() *
-       proteinDensity.raw().array())
-          .sum();
+      parallelSum(
+          mesh->nVertices(),
+          [this](std::size_t i) {
+            return vpg->vertexDualAreas[i] * proteinDensity[i] *
+                   proteinDensity[i];
+          },
+          nThreads);
 }
 
 void System::computeProteinInteriorPenalty() {
   // interior method to constrain protein density to remain from 0 to 1
   energy.proteinInteriorPenalty =
       -parameters.proteinDistribution.lambdaPhi *
-      ((proteinDensity.raw().array()).log().sum() +
-       (1 - proteinDensity.raw().array()).log().sum());
+      (parallelSum(
+           mesh->nVertices(),
+           [this](std::size_t i) { return std::log(proteinDensity[i]); },
+           nThreads) +
+       parallelSum(
+           mesh->nVertices(),
+           [this](std::size_t i) { return std::log(1 - proteinDensity[i]); },
+           nThreads));
 }
 
 void System::computeSelfAvoidanceEnergy() {
   const double d0 = parameters.selfAvoidance.d;
   const double mu = parameters.selfAvoidance.mu;
-  const double n = parameters.selfAvoidance.n;
   double e = 0.0;
   projectedCollideTime = std::numeric_limits<double>::max();
-  for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
+  auto addPairEnergy = [&](std::size_t i, std::size_t j) {
     gc::Vertex vi{mesh->vertex(i)};
-    gc::VertexData<bool> neighborList(*mesh, false);
-    meshProcessor.meshMutator.markVertices(neighborList, vi, n);
-    for (std::size_t j = i + 1; j < mesh->nVertices(); ++j) {
-      if (neighborList[j])
-        continue;
-      gc::Vertex vj{mesh->vertex(j)};
-
-      // double penalty = mu * vpg->vertexDualAreas[vi] * proteinDensity[vi] *
-      //                  vpg->vertexDualAreas[vj] * proteinDensity[vj];
-      double penalty = mu * proteinDensity[vi] * proteinDensity[vj];
-      // double penalty = mu;
-      // double penalty = mu * vpg->vertexDualAreas[vi] *
-      // vpg->vertexDualAreas[vj];
-
-      gc::Vector3 r =
-          vpg->inputVertexPositions[vj] - vpg->inputVertexPositions[vi];
-      double distance = gc::norm(r) - d0;
-      double collideTime = distance / gc::dot(velocity[vi] - velocity[vj], r);
-      if (collideTime < projectedCollideTime &&
-          gc::dot(velocity[vi] - velocity[vj], r) > 0)
-        projectedCollideTime = collideTime;
-      // e -= penalty * log(distance);
-      e += penalty / distance;
+    gc::Vertex vj{mesh->vertex(j)};
+
+    // double penalty = mu * vpg->vertexDualAreas[vi] * proteinDensity[vi] *
+    //                  vpg->vertexDualAreas[vj] * proteinDensity[vj];
+    double penalty = mu * proteinDensity[vi] * proteinDensity[vj];
+    // double penalty = mu;
+    // double penalty = mu * vpg->vertexDualAreas[vi] *
+    // vpg->vertexDualAreas[vj];
+
+    gc::Vector3 r =
+        vpg->inputVertexPositions[vj] - vpg->inputVertexPositions[vi];
+    double distance = gc::norm(r) - d0;
+    double collideTime = distance / gc::dot(velocity[vi] - velocity[vj], r);
+    if (collideTime < projectedCollideTime &&
+        gc::dot(velocity[vi] - velocity[vj], r) > 0)
+      projectedCollideTime = collideTime;
+    // e -= penalty * log(distance);
+    e += penalty / distance;
+  };
+
+  if (parameters.selfAvoidance.isFaceContact) {
+    findSelfContacts();
+    for (const Proximity &contact : selfContacts) {
+      double distance = gc::norm(contact.difference) - d0;
+      gc::Vector3 rate{0, 0, 0};
+      for (std::size_t k = 0; k < 4; ++k)
+        rate += contact.coefficients[k] * velocity[contact.vertices[k]];
+      double approach = -gc::dot(rate, contact.difference);
+      if (approach > 0 && distance / approach < projectedCollideTime)
+        projectedCollideTime = distance / approach;
+      e += mu * contact.weight / distance;
+    }
+  } else if (parameters.selfAvoidance.cutoff > 0) {
+    // pairs beyond the cutoff neither contribute nor collide
+    findSelfAvoidancePairs();
+    for (const SpatialHash::Pair &ij : selfAvoidancePairs)
+      addPairEnergy(ij.first, ij.second);
+  } else if (parameters.selfAvoidance.theta > 0) {
+    // every pair is visited from both vertices, and the far field monopoles
+    // lie beyond the exclusion radius, so that they contain no excluded
+    // neighbor and stay farther than d
+    const double theta = parameters.selfAvoidance.theta;
+    const double radius = computeSelfAvoidanceExclusionRadius();
+    updateSelfAvoidanceExclusions();
+    octree.build(vpg->inputVertexPositions, proteinDensity);
+    std::vector<double> vertexCollideTime(mesh->nVertices(),
+                                          projectedCollideTime);
+    auto vertexEnergy = [&](std::size_t i) {
+      const gc::Vector3 &xi = vpg->inputVertexPositions[i];
+      double potential = 0;
+      octree.traverse(
+          xi, theta, radius,
+          [&](std::size_t j) {
+            if (isSelfAvoidanceExcluded(i, j))
+              return;
+            gc::Vector3 r = vpg->inputVertexPositions[j] - xi;
+            double distance = gc::norm(r) - d0;
+            double approach = gc::dot(velocity[i] - velocity[j], r);
+            if (approach > 0)
+              vertexCollideTime[i] =
+                  std::min(vertexCollideTime[i], distance / approach);
+            potential += proteinDensity[j] / distance;
+          },
+          [&](const gc::Vector3 &xj, double phij) {
+            potential += phij / (gc::norm(xj - xi) - d0);
+          });
+      return mu * proteinDensity[i] * potential;
+    };
+    e = 0.5 * parallelSum(mesh->nVertices(), vertexEnergy, nThreads);
+    projectedCollideTime =
+        *std::min_element(vertexCollideTime.begin(), vertexCollideTime.end());
+  } else {
+    updateSelfAvoidanceExclusions();
+    for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
+      std::size_t k = selfAvoidanceExclusionOffsets[i];
+      for (std::size_t j = i + 1; j < mesh->nVertices(); ++j) {
+        if (k < selfAvoidanceExclusionOffsets[i + 1] &&
+            selfAvoidanceExclusions[k] == j)
+          ++k;
+        else
+          addPairEnergy(i, j);
+      }
     }
   }
   if (projectedCollideTime == std::numeric_limits<double>::max())
@@ -188,12 +278,13 @@ void System::computeDirichletEnergy() {
   }
 
   // explicit dirichlet energy
-  energy.dirichletEnergy = 0;
-  for (gcs::Face f : mesh->faces()) {
-    energy.dirichletEnergy += 0.5 * parameters.dirichlet.eta *
-                              proteinDensityGradient[f].norm2() *
-                              vpg->faceAreas[f];
-  }
+  energy.dirichletEnergy = parallelSum(
+      mesh->nFaces(),
+      [this](std::size_t f) {
+        return 0.5 * parameters.dirichlet.eta *
+               proteinDensityGradient[f].norm2() * vpg->faceAreas[f];
+      },
+      nThreads);
 
   // alternative dirichlet energy after integration by part
   // E.dE = 0.5 * P.eta * proteinDensity.raw().transpose() *
@@ -237,6 +328,10 @@ double System::computePotentialEnergy() {
     computeProteinInteriorPenalty();
   }
 
+  return sumPotentialEnergy();
+}
+
+double System::sumPotentialEnergy() {
   // summerize internal potential energy
   energy.potentialEnergy =
       energy.bendingEnergy + energy.deviatoricEnergy + energy.surfaceEnergy +
@@ -246,6 +341,223 @@ double System::computePotentialEnergy() {
   return energy.potentialEnergy;
 }
 
+void System::computeVertexEnergies(std::size_t i) {
+  const Connectivity &cn = connectivity;
+  const double dualArea = vpg->vertexDualAreas[i];
+  const double meanCurvature = vpg->vertexMeanCurvatures[i];
+
+  // same arithmetic as computeBendingEnergy and computeDeviatoricEnergy
+  double H_difference = std::abs(meanCurvature / dualArea - H0[i]);
+  vertexEnergies(i, 0) = Kb[i] * dualArea * (H_difference * H_difference);
+  vertexEnergies(i, 1) =
+      Kd[i] * (meanCurvature * meanCurvature / dualArea -
+               vpg->vertexGaussianCurvatures[i]);
+  vertexEnergies(i, 2) = dualArea * proteinDensity[i];
+  vertexEnergies(i, 3) = dualArea * proteinDensity[i] * proteinDensity[i];
+
+  double dirichletEnergy = 0;
+  if (parameters.dirichlet.eta != 0) {
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k) {
+      std::size_t he = cn.outgoingHalfedges[k];
+      if (!cn.isInterior(he))
+        continue;
+      std::size_t f = cn.halfedgeFace[he];
+      if (cn.faceHalfedge[f] == he)
+        dirichletEnergy += 0.5 * parameters.dirichlet.eta *
+                           proteinDensityGradient[f].norm2() *
+                           vpg->faceAreas[f];
+    }
+  }
+  vertexEnergies(i, 4) = dirichletEnergy;
+}
+
+bool System::isTrialEnergySupported() const {
+  return parameters.selfAvoidance.mu == 0 && parameters.external.Kf == 0;
+}
+
+double
+System::computeTrialPotentialEnergy(const EigenVectorX3dr &trialPositions,
+                                    const EigenVectorX1d &trialProteinDensity) {
+  if (!isTrialEnergySupported())
+    mem3dg_runtime_error("computeTrialPotentialEnergy: self-avoidance and "
+                         "external force need updateConfigurations!");
+  if (!connectivity.isCurrent(*mesh))
+    connectivity.build(*mesh);
+  const Connectivity &cn = connectivity;
+  const bool isDeviatoric =
+      parameters.bending.Kd != 0 || parameters.bending.Kdc != 0;
+  const double eta = parameters.dirichlet.eta;
+  const bool isHillRelation = parameters.bending.relation == "hill";
+  if (!isHillRelation && parameters.bending.relation != "linear")
+    mem3dg_runtime_error(
+        "computeTrialPotentialEnergy: P.relation is invalid option!");
+  auto position = [&trialPositions](std::size_t i) {
+    return gc::Vector3{trialPositions(i, 0), trialPositions(i, 1),
+                       trialPositions(i, 2)};
+  };
+
+  // workspaces are only reallocated after mesh mutation
+  trialFaceAreaVectors.resize(cn.nFaces);
+  trialVertexTerms.resize(cn.nVertices, Eigen::NoChange);
+
+  const std::ptrdiff_t nFaces = cn.nFaces, nVertices = cn.nVertices;
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t f = 0; f < nFaces; ++f) {
+    std::size_t he = cn.faceHalfedge[f], he_next = cn.halfedgeNext[he];
+    gc::Vector3 p0 = position(cn.halfedgeTail[he]);
+    trialFaceAreaVectors[f] =
+        gc::cross(position(cn.halfedgeTail[he_next]) - p0,
+                  position(cn.halfedgeTip[he_next]) - p0);
+  }
+
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+    const gc::Vector3 pi = position(i);
+    double dualArea = 0, meanCurvature = 0, angleSum = 0;
+    double dirichletEnergy = 0, area = 0, signedVolume = 0;
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k) {
+      std::size_t he = cn.outgoingHalfedges[k];
+      std::size_t he_twin = cn.halfedgeTwin[he];
+      gc::Vector3 edgeVector = position(cn.halfedgeTip[he]) - pi;
+      double edgeLength = gc::norm(edgeVector);
+
+      // the dihedral angle does not depend on the orientation of the edge
+      if (cn.isInterior(he) && cn.isInterior(he_twin)) {
+        gc::Vector3 N1 = gc::unit(trialFaceAreaVectors[cn.halfedgeFace[he]]);
+        gc::Vector3 N2 =
+            gc::unit(trialFaceAreaVectors[cn.halfedgeFace[he_twin]]);
+        meanCurvature +=
+            std::atan2(gc::dot(edgeVector / edgeLength, gc::cross(N1, N2)),
+                       gc::dot(N1, N2)) *
+            edgeLength;
+      }
+      if (!cn.isInterior(he))
+        continue;
+
+      std::size_t f = cn.halfedgeFace[he];
+      double faceArea = 0.5 * gc::norm(trialFaceAreaVectors[f]);
+      dualArea += faceArea / 3;
+      gc::Vector3 oppositeVector =
+          position(cn.halfedgeTip[cn.halfedgeNext[he]]) - pi;
+      if (isDeviatoric) {
+        double cosine =
+            gc::dot(gc::unit(edgeVector), gc::unit(oppositeVector));
+        angleSum += std::acos(std::max(-1.0, std::min(1.0, cosine)));
+      }
+
+      // face terms at the tail of the canonical halfedge
+      if (cn.faceHalfedge[f] != he)
+        continue;
+      area += faceArea;
+      gc::Vector3 p1 = pi + edgeVector, p2 = pi + oppositeVector;
+      gc::Vector3 p0 = pi;
+      signedVolume += signedVolumeFromFace(p0, p1, p2);
+      if (eta != 0) {
+        // same as computeGradient, each vertex weighs the opposite edge
+        gc::Vector3 normal = trialFaceAreaVectors[f] / (2 * faceArea);
+        gc::Vector3 gradient =
+            trialProteinDensity[cn.halfedgeTip[cn.halfedgeNext[he]]] *
+                gc::cross(normal, edgeVector) +
+            trialProteinDensity[i] * gc::cross(normal, p2 - p1) +
+            trialProteinDensity[cn.halfedgeTip[he]] *
+                gc::cross(normal, p0 - p2);
+        gradient /= 2 * faceArea;
+        dirichletEnergy += 0.5 * eta * gradient.norm2() * faceArea;
+      }
+    }
+    meanCurvature /= 4;
+
+    // protein density dependent moduli, as in updateConfigurations
+    double phi = trialProteinDensity[i];
+    double coverage = isHillRelation ? phi * phi / (1 + phi * phi) : phi;
+    double H0i = parameters.bending.H0c * coverage;
+    double Kbi = parameters.bending.Kb + parameters.bending.Kbc * coverage;
+    double Kdi = parameters.bending.Kd + parameters.bending.Kdc * coverage;
+
+    double H_difference = std::abs(meanCurvature / dualArea - H0i);
+    trialVertexTerms(i, 0) = Kbi * dualArea * (H_difference * H_difference);
+    trialVertexTerms(i, 1) =
+        isDeviatoric
+            ? Kdi * (meanCurvature * meanCurvature / dualArea -
+                     ((cn.isBoundaryVertex(i) ? 1 : 2) * constants::PI -
+                      angleSum))
+            : 0;
+    trialVertexTerms(i, 2) = dualArea * phi;
+    trialVertexTerms(i, 3) = dualArea * phi * phi;
+    trialVertexTerms(i, 4) = dirichletEnergy;
+    trialVertexTerms(i, 5) = area;
+    trialVertexTerms(i, 6) = signedVolume;
+  }
+  auto sumVertexTerms = [this](Eigen::Index k) {
+    return parallelSum(
+        trialVertexTerms.rows(),
+        [this, k](std::size_t i) { return trialVertexTerms(i, k); }, nThreads);
+  };
+
+  // global quantities, with the holes of an open mesh filled as in
+  // getMeshVolume
+  double trialArea = sumVertexTerms(5) + parameters.tension.A_res;
+  double trialVolume = sumVertexTerms(6) + parameters.osmotic.V_res;
+  for (gcs::BoundaryLoop bl : mesh->boundaryLoops()) {
+    std::size_t theVertex = bl.halfedge().tailVertex().getIndex();
+    gc::Vector3 p0 = position(theVertex);
+    for (gcs::Halfedge he : bl.adjacentHalfedges()) {
+      std::size_t tail = he.tailVertex().getIndex(),
+                  tip = he.tipVertex().getIndex();
+      if (tail != theVertex && tip != theVertex) {
+        gc::Vector3 p1 = position(tail), p2 = position(tip);
+        trialVolume += signedVolumeFromFace(p1, p2, p0);
+      }
+    }
+  }
+
+  trialEnergy.bendingEnergy = sumVertexTerms(0);
+  trialEnergy.deviatoricEnergy = isDeviatoric ? sumVertexTerms(1) : 0;
+  trialEnergy.surfaceEnergy =
+      getSurfaceEnergy(trialArea, getSurfaceTension(trialArea));
+  trialEnergy.pressureEnergy =
+      getPressureEnergy(trialVolume, getOsmoticPressure(trialVolume));
+  trialEnergy.adsorptionEnergy =
+      parameters.adsorption.epsilon != 0
+          ? parameters.adsorption.epsilon * sumVertexTerms(2)
+          : 0;
+  trialEnergy.aggregationEnergy =
+      parameters.aggregation.chi != 0
+          ? parameters.aggregation.chi * sumVertexTerms(3)
+          : 0;
+  trialEnergy.dirichletEnergy = eta != 0 ? sumVertexTerms(4) : 0;
+  trialEnergy.selfAvoidancePenalty = 0;
+  trialEnergy.proteinInteriorPenalty = 0;
+  if (parameters.variation.isProteinVariation &&
+      parameters.proteinDistribution.lambdaPhi != 0) {
+    trialEnergy.proteinInteriorPenalty =
+        -parameters.proteinDistribution.lambdaPhi *
+        (parallelSum(
+             cn.nVertices,
+             [&](std::size_t i) { return std::log(trialProteinDensity[i]); },
+             nThreads) +
+         parallelSum(
+             cn.nVertices,
+             [&](std::size_t i) {
+               return std::log(1 - trialProteinDensity[i]);
+             },
+             nThreads));
+  }
+  trialEnergy.potentialEnergy =
+      trialEnergy.bendingEnergy + trialEnergy.deviatoricEnergy +
+      trialEnergy.surfaceEnergy + trialEnergy.pressureEnergy +
+      trialEnergy.adsorptionEnergy + trialEnergy.dirichletEnergy +
+      trialEnergy.aggregationEnergy + trialEnergy.selfAvoidancePenalty +
+      trialEnergy.proteinInteriorPenalty;
+  return trialEnergy.potentialEnergy;
+}
+
 double System::computeIntegratedPower(double dt) {
   prescribeExternalForce();
   return dt * rowwiseDotProduct(toMatrix(forces.externalForceVec),
@@ -266,7 +578,10 @@ double System::computeExternalWork(double currentTime, double dt) {
 
 double System::computeKineticEnergy() {
   energy.kineticEnergy =
-      0.5 * Eigen::square(toMatrix(velocity).array()).matrix().sum();
+      0.5 * parallelSum(
+                mesh->nVertices(),
+                [this](std::size_t i) { return velocity[i].norm2(); },
+                nThreads);
   // energy.kineticEnergy =
   //     0.5 * rowwiseScalarProduct(toMatrix(vpg->vertexDualAreas).array(),
   //                                Eigen::square(toMatrix(velocity).array()))
@@ -276,6 +591,10 @@ double System::computeKineticEnergy() {
 
 double System::computeTotalEnergy() {
   computePotentialEnergy();
+  return sumTotalEnergy();
+}
+
+double System::sumTotalEnergy() {
   computeKineticEnergy();
   if (time == energy.time) {
     energy.totalEnergy =
@@ -288,6 +607,63 @@ double System::computeTotalEnergy() {
   return energy.totalEnergy;
 }
 
+std::tuple<const Forces &, const Energy &>
+System::computePhysicalForcingAndEnergy(double timeStep) {
+  auto sumVertexEnergies = [this](Eigen::Index k) {
+    return parallelSum(
+        vertexEnergies.rows(),
+        [this, k](std::size_t i) { return vertexEnergies(i, k); }, nThreads);
+  };
+
+  if (!parameters.variation.isShapeVariation || isMechanicalForcesCurrent) {
+    // no mechanical force sweep to fuse with
+    computePhysicalForcing(timeStep);
+    computeTotalEnergy();
+    return std::tie(forces, energy);
+  }
+
+  isVertexEnergySweep = true;
+  computePhysicalForcing(timeStep);
+  isVertexEnergySweep = false;
+
+  // fundamental internal potential energy
+  energy.bendingEnergy = sumVertexEnergies(0);
+  energy.deviatoricEnergy = sumVertexEnergies(1);
+  energy.surfaceEnergy = 0;
+  energy.pressureEnergy = 0;
+  energy.adsorptionEnergy = 0;
+  energy.aggregationEnergy = 0;
+  energy.dirichletEnergy = 0;
+  energy.selfAvoidancePenalty = 0;
+  energy.proteinInteriorPenalty = 0;
+  computeSurfaceEnergy();
+  computePressureEnergy();
+
+  // optional internal potential energy
+  if (parameters.adsorption.epsilon != 0) {
+    energy.adsorptionEnergy =
+        parameters.adsorption.epsilon * sumVertexEnergies(2);
+  }
+  if (parameters.aggregation.chi != 0) {
+    energy.aggregationEnergy =
+        parameters.aggregation.chi * sumVertexEnergies(3);
+  }
+  if (parameters.dirichlet.eta != 0) {
+    energy.dirichletEnergy = sumVertexEnergies(4);
+  }
+  if (parameters.selfAvoidance.mu != 0) {
+    computeSelfAvoidanceEnergy();
+  }
+  if (parameters.variation.isProteinVariation &&
+      parameters.proteinDistribution.lambdaPhi != 0) {
+    computeProteinInteriorPenalty();
+  }
+
+  sumPotentialEnergy();
+  sumTotalEnergy();
+  return std::tie(forces, energy);
+}
+
 void System::computeGradient(gcs::VertexData<double> &quantities,
                              gcs::FaceData<gc::Vector3> &gradient) {
   if ((quantities.raw().array() == quantities.raw()[0]).all()) {
@@ -14,9 +14,13 @@
 
 // uncomment to disable assert()
 // #define NDEBUG
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <set>
+#include <utility>
 
 #include <geometrycentral/numerical/linear_solvers.h>
 #include <geometrycentral/surface/halfedge_mesh.h>
@@ -30,6 +34,7 @@
 #include "geometrycentral/surface/halfedge_element_types.h"
 #include "geometrycentral/surface/surface_mesh.h"
 #include "mem3dg/meshops.h"
+#include "mem3dg/parallel.h"
 #include "mem3dg/solver/system.h"
 #include "mem3dg/type_utilities.h"
 #include <Eigen/Core>
@@ -238,15 +243,360 @@ gcs::VertexData<gc::Vector3> System::halfedgeVectorToVertexVector(
   return vector;
 }
 
+void System::computeVariationalVectors(unsigned forceTerms) {
+  VariationalVectors &vv = variationalVectors;
+
+  const std::ptrdiff_t nVertices = mesh->nVertices();
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+    vv.meanCurvature[i] =
+        vpg->vertexMeanCurvatures[i] / vpg->vertexDualAreas[i];
+  }
+
+  const std::ptrdiff_t nHalfedges = mesh->nHalfedges();
+  if (connectivity.hasBoundary) {
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+    for (std::ptrdiff_t k = 0; k < nHalfedges; ++k) {
+      computeHalfedgeVariationalVectors<true>(k, forceTerms);
+    }
+  } else {
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+    for (std::ptrdiff_t k = 0; k < nHalfedges; ++k) {
+      computeHalfedgeVariationalVectors<false>(k, forceTerms);
+    }
+  }
+}
+
+void System::computeVariationalVectors(
+    const std::vector<std::size_t> &vertices,
+    const std::vector<std::size_t> &halfedges, unsigned forceTerms) {
+  VariationalVectors &vv = variationalVectors;
+  for (std::size_t i : vertices) {
+    vv.meanCurvature[i] =
+        vpg->vertexMeanCurvatures[i] / vpg->vertexDualAreas[i];
+  }
+  for (std::size_t k : halfedges) {
+    if (connectivity.hasBoundary)
+      computeHalfedgeVariationalVectors<true>(k, forceTerms);
+    else
+      computeHalfedgeVariationalVectors<false>(k, forceTerms);
+  }
+}
+
+template <bool IsOpenMesh>
+void System::computeHalfedgeVariationalVectors(std::size_t k,
+                                               unsigned forceTerms) {
+  VariationalVectors &vv = variationalVectors;
+  const bool isCurvature = forceTerms & (BENDING | DEVIATORIC);
+  const bool isDeviatoric = forceTerms & DEVIATORIC;
+  const bool isLineTension = forceTerms & LINE_TENSION;
+  gc::Halfedge he{mesh->halfedge(k)};
+
+  if (IsOpenMesh) {
+    vv.areaGradient[he] = 2 * computeHalfedgeMeanCurvatureVector(*vpg, he);
+    vv.volumeVariationVector[he] =
+        computeHalfedgeVolumeVariationVector(*vpg, he);
+  } else {
+    // both faces of the halfedge exist on a closed mesh
+    std::size_t fID = he.face().getIndex();
+    std::size_t fID_he_twin = he.twin().face().getIndex();
+    gc::Halfedge he_twin_next_next = he.twin().next().next();
+    gc::Vector3 areaGrad = 0.25 * gc::cross(vpg->faceNormals[fID],
+                                            vecFromHalfedge(he.next(), *vpg));
+    areaGrad += 0.25 * gc::cross(vpg->faceNormals[fID_he_twin],
+                                 vecFromHalfedge(he_twin_next_next, *vpg));
+    vv.areaGradient[he] = 2 * (areaGrad / 2);
+    vv.volumeVariationVector[he] =
+        vpg->faceNormals[fID] * vpg->faceAreas[fID] / 3;
+  }
+
+  if (isCurvature) {
+    double l = vpg->edgeLengths[he.edge()];
+    if (IsOpenMesh) {
+      vv.gaussianCurvatureVector[he] =
+          computeHalfedgeGaussianCurvatureVector(*vpg, he);
+      // the dihedral angle gradient wrt the tip vertex is the one of the twin
+      // wrt its tail, hence two entries per halfedge cover all four vertices
+      vv.dihedralGradientTail[he] = l * dihedralAngleGradient(he, he.vertex());
+      vv.dihedralGradientOpposite[he] =
+          l * dihedralAngleGradient(he, he.next().next().vertex());
+    } else {
+      // dihedralAngleGradient without the boundary and vertex checks
+      gc::Vector3 n = vpg->faceNormals[he.face()];
+      gc::Vector3 n_twin = vpg->faceNormals[he.twin().face()];
+      double cot_next = vpg->halfedgeCotanWeights[he.next()];
+      double cot_next_next = vpg->halfedgeCotanWeights[he.next().next()];
+      double cot_twin_next = vpg->halfedgeCotanWeights[he.twin().next()];
+      vv.gaussianCurvatureVector[he] = 0.5 *
+                                       vpg->edgeDihedralAngles[he.edge()] *
+                                       (-vecFromHalfedge(he, *vpg)).unit();
+      vv.dihedralGradientTail[he] =
+          l * ((cot_next_next * n + cot_twin_next * n_twin) / l);
+      vv.dihedralGradientOpposite[he] =
+          l * ((-(cot_next_next + cot_next) * n) / l);
+    }
+  }
+
+  if (!IsOpenMesh || he.isInterior()) {
+    std::size_t fID = he.face().getIndex();
+    if (isLineTension)
+      computeHalfedgeLineTensionVectors(he);
+
+    if (isDeviatoric) {
+      // same arithmetic as cornerAngleGradient, evaluated once for all three
+      // vertices of the corner
+      gc::Vector3 n = vpg->faceNormals[fID];
+      gc::Vector3 ej = vecFromHalfedge(he, *vpg);
+      gc::Vector3 ek = vecFromHalfedge(he.next().next(), *vpg);
+      gc::Vector3 grad_anglek = -gc::cross(n, ej).normalize() / gc::norm(ej);
+      gc::Vector3 grad_anglej = -gc::cross(n, ek).normalize() / gc::norm(ek);
+      vv.cornerAngleGradientSelf[he] = -(grad_anglek + grad_anglej);
+      vv.cornerAngleGradientTip[he] = grad_anglek;
+      vv.cornerAngleGradientOpposite[he] = grad_anglej;
+    }
+  } else {
+    vv.oneSidedAreaGradient[he] = gc::Vector3{0, 0, 0};
+    vv.dirichletVector[he] = gc::Vector3{0, 0, 0};
+    vv.cornerAngleGradientSelf[he] = gc::Vector3{0, 0, 0};
+    vv.cornerAngleGradientTip[he] = gc::Vector3{0, 0, 0};
+    vv.cornerAngleGradientOpposite[he] = gc::Vector3{0, 0, 0};
+  }
+}
+
+void System::computeHalfedgeLineTensionVectors(gcs::Halfedge he) {
+  VariationalVectors &vv = variationalVectors;
+  std::size_t fID = he.face().getIndex();
+  vv.oneSidedAreaGradient[he] =
+      0.5 * gc::cross(vpg->faceNormals[fID], vecFromHalfedge(he.next(), *vpg));
+  vv.dirichletVector[he] =
+      computeGradientNorm2Gradient(he, proteinDensity) / vpg->faceAreas[fID];
+}
+
+void System::computeBatchedVariationalVectors(unsigned forceTerms) {
+  VariationalVectors &vv = variationalVectors;
+  const Connectivity &cn = connectivity;
+  const bool isCurvature = forceTerms & (BENDING | DEVIATORIC);
+  const bool isDeviatoric = forceTerms & DEVIATORIC;
+
+  const std::ptrdiff_t nVertices = mesh->nVertices();
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+    vv.meanCurvature[i] =
+        vpg->vertexMeanCurvatures[i] / vpg->vertexDualAreas[i];
+  }
+
+  // blocks of outgoing halfedges, each thread working in its own batch
+  const std::size_t nOutgoing = cn.outgoingHalfedges.size();
+  const std::ptrdiff_t nBlocks =
+      (nOutgoing + simd::BATCH_SIZE - 1) / simd::BATCH_SIZE;
+  bendingBatches.resize(getNumThreads(nThreads));
+  for (simd::BendingBatch &batch : bendingBatches)
+    batch.resize(simd::BATCH_SIZE);
+  if (isCurvature)
+    bendingTerms.resize(nOutgoing);
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t b = 0; b < nBlocks; ++b) {
+    simd::BendingBatch &batch = bendingBatches[getThreadNum()];
+    const std::size_t begin = b * simd::BATCH_SIZE;
+    const std::size_t n = std::min(nOutgoing - begin, simd::BATCH_SIZE);
+    if (cn.hasBoundary)
+      gatherBendingBatch<true>(batch, begin, n, isCurvature);
+    else
+      gatherBendingBatch<false>(batch, begin, n, isCurvature);
+    simd::computeGeometryBatch(instructionSet, batch, 0, n, isDeviatoric);
+    if (isCurvature)
+      simd::computeBendingBatch(instructionSet, batch, 0, n);
+
+    for (std::size_t m = 0; m < n; ++m) {
+      std::size_t he = cn.outgoingHalfedges[begin + m];
+      vv.areaGradient[he] = batch.areaGrad.get(m);
+      vv.volumeVariationVector[he] = batch.volumeVariation.get(m);
+      if (isCurvature) {
+        vv.gaussianCurvatureVector[he] = batch.gaussVec.get(m);
+        vv.dihedralGradientTail[he] = batch.schlafliVec1.get(m);
+        vv.dihedralGradientOpposite[he] = batch.dihedralOpposite.get(m);
+        bendingTerms[begin + m] = simd::BendingTerms{
+            batch.schlafliTerm.get(m), batch.areaGradTerm.get(m),
+            batch.gaussTerm.get(m), batch.deviatoricMeanTerm.get(m)};
+      }
+      if (isDeviatoric) {
+        // exterior halfedges have no corner
+        bool interiorHalfedge = !cn.hasBoundary || cn.isInterior(he);
+        vv.cornerAngleGradientSelf[he] =
+            interiorHalfedge ? batch.cornerAngleGradientSelf.get(m)
+                             : gc::Vector3{0, 0, 0};
+        vv.cornerAngleGradientTip[he] =
+            interiorHalfedge ? batch.cornerAngleGradientTip.get(m)
+                             : gc::Vector3{0, 0, 0};
+        vv.cornerAngleGradientOpposite[he] =
+            interiorHalfedge ? batch.cornerAngleGradientOpposite.get(m)
+                             : gc::Vector3{0, 0, 0};
+      }
+    }
+  }
+
+  if (forceTerms & LINE_TENSION) {
+    const std::ptrdiff_t nHalfedges = mesh->nHalfedges();
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+    for (std::ptrdiff_t k = 0; k < nHalfedges; ++k) {
+      if (!cn.hasBoundary || cn.isInterior(k)) {
+        computeHalfedgeLineTensionVectors(gc::Halfedge{mesh->halfedge(k)});
+      } else {
+        vv.oneSidedAreaGradient[k] = gc::Vector3{0, 0, 0};
+        vv.dirichletVector[k] = gc::Vector3{0, 0, 0};
+      }
+    }
+  }
+}
+
+template <bool IsOpenMesh>
+void System::gatherBendingBatch(simd::BendingBatch &batch, std::size_t begin,
+                                std::size_t n, bool isCurvature) {
+  const VariationalVectors &vv = variationalVectors;
+  const Connectivity &cn = connectivity;
+  const gcs::VertexData<gc::Vector3> &pos = vpg->inputVertexPositions;
+  const gcs::HalfedgeData<double> &cot = vpg->halfedgeCotanWeights;
+  const gc::Vector3 zero{0, 0, 0};
+  auto edgeVec = [&](std::size_t he) {
+    return pos[cn.halfedgeTip[he]] - pos[cn.halfedgeTail[he]];
+  };
+
+  for (std::size_t m = 0; m < n; ++m) {
+    std::size_t he = cn.outgoingHalfedges[begin + m];
+    std::size_t he_next = cn.halfedgeNext[he];
+    std::size_t he_next_next = cn.halfedgeNext[he_next];
+    std::size_t he_twin = cn.halfedgeTwin[he];
+    std::size_t he_twin_next = cn.halfedgeNext[he_twin];
+    std::size_t he_twin_next_next = cn.halfedgeNext[he_twin_next];
+    bool interiorHalfedge = !IsOpenMesh || cn.isInterior(he);
+    bool interiorTwinHalfedge = !IsOpenMesh || cn.isInterior(he_twin);
+
+    batch.faceNormal.set(m, interiorHalfedge
+                                ? vpg->faceNormals[cn.halfedgeFace[he]]
+                                : zero);
+    batch.twinFaceNormal.set(m, interiorTwinHalfedge
+                                    ? vpg->faceNormals[cn.halfedgeFace[he_twin]]
+                                    : zero);
+    batch.faceArea[m] =
+        interiorHalfedge ? vpg->faceAreas[cn.halfedgeFace[he]] : 0;
+    batch.edgeVec.set(m, edgeVec(he));
+    batch.nextEdgeVec.set(m, edgeVec(he_next));
+    batch.nextNextEdgeVec.set(m, edgeVec(he_next_next));
+    batch.twinNextNextEdgeVec.set(m, edgeVec(he_twin_next_next));
+    if (!isCurvature)
+      continue;
+
+    // the dihedral angle and its gradients vanish on boundary edges
+    bool boundaryEdge = IsOpenMesh && cn.isBoundaryEdge(he);
+    bool boundaryNextEdge = IsOpenMesh && cn.isBoundaryEdge(he_next);
+    bool boundaryTwinNextNextEdge =
+        IsOpenMesh && cn.isBoundaryEdge(he_twin_next_next);
+    batch.dihedralAngle[m] =
+        boundaryEdge ? 0 : vpg->edgeDihedralAngles[cn.halfedgeEdge[he]];
+    batch.tailCotan[m] = boundaryEdge ? 0 : cot[he_next_next];
+    batch.twinTailCotan[m] = boundaryEdge ? 0 : cot[he_twin_next];
+    batch.oppositeCotan[m] =
+        boundaryEdge ? 0 : -(cot[he_next_next] + cot[he_next]);
+    batch.nextOppositeCotan[m] =
+        boundaryNextEdge ? 0 : -(cot[he] + cot[he_next_next]);
+    batch.twinOppositeCotan[m] =
+        boundaryTwinNextNextEdge ? 0 : -(cot[he_twin_next] + cot[he_twin]);
+
+    std::size_t i = cn.halfedgeTail[he];
+    std::size_t j = cn.halfedgeTip[he];
+    double Hi = vv.meanCurvature[i], Hj = vv.meanCurvature[j];
+    double H0i = H0[i], H0j = H0[j];
+    double Kbi = Kb[i], Kbj = Kb[j];
+    double Kdi = Kd[i], Kdj = Kd[j];
+    batch.schlafliWeight1[m] = Kbi * (Hi - H0i);
+    batch.schlafliWeight2[m] = Kbj * (Hj - H0j);
+    batch.areaGradWeight[m] = Kbi * (H0i * H0i - Hi * Hi) / 3 +
+                              Kbj * (H0j * H0j - Hj * Hj) * 2 / 3;
+    batch.gaussWeight[m] = Kbi * (Hi - H0i) + Kbj * (Hj - H0j);
+    batch.deviatoricGaussWeight[m] = Kdi * Hi + Kdj * Hj;
+    batch.deviatoricAreaGradWeight[m] =
+        Kdi * (-Hi * Hi) / 3 + Kdj * (-Hj * Hj) * 2 / 3;
+    batch.deviatoricSchlafliWeight1[m] = Kdi * Hi;
+    batch.deviatoricSchlafliWeight2[m] = Kdj * Hj;
+  }
+}
+
+namespace {
+template <bool IsOpenMesh, std::size_t... ForceTerms>
+std::array<System::MechanicalForcesKernel, sizeof...(ForceTerms)>
+makeMechanicalForcesKernels(std::index_sequence<ForceTerms...>) {
+  return {{&System::computeMechanicalForcesKernel<ForceTerms, IsOpenMesh>...}};
+}
+} // namespace
+
+void System::updateActiveForceTerms() {
+  activeForceTerms = 0;
+  if (parameters.bending.Kb != 0 || parameters.bending.Kbc != 0)
+    activeForceTerms |= BENDING;
+  if (parameters.bending.Kd != 0 || parameters.bending.Kdc != 0)
+    activeForceTerms |= DEVIATORIC;
+  if (parameters.adsorption.epsilon != 0)
+    activeForceTerms |= ADSORPTION;
+  if (parameters.aggregation.chi != 0)
+    activeForceTerms |= AGGREGATION;
+  if (parameters.dirichlet.eta != 0)
+    activeForceTerms |= LINE_TENSION;
+}
+
+System::MechanicalForcesKernel System::getMechanicalForcesKernel() const {
+  static const std::array<MechanicalForcesKernel, ALL_FORCE_TERMS + 1>
+      openMeshKernels = makeMechanicalForcesKernels<true>(
+          std::make_index_sequence<ALL_FORCE_TERMS + 1>{});
+  static const std::array<MechanicalForcesKernel, ALL_FORCE_TERMS + 1>
+      closedMeshKernels = makeMechanicalForcesKernels<false>(
+          std::make_index_sequence<ALL_FORCE_TERMS + 1>{});
+  return connectivity.hasBoundary
+             ? openMeshKernels[activeForceTerms & ALL_FORCE_TERMS]
+             : closedMeshKernels[activeForceTerms & ALL_FORCE_TERMS];
+}
+
 void System::computeMechanicalForces() {
   assert(mesh->isCompressed());
   // if(!mesh->isCompressed()){
   //   mem3dg_runtime_error("Mesh must be compressed to compute forces!");
   // }
 
-  for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
-    computeMechanicalForces(i);
+  // the vectorized precompute also provides the bending and deviatoric mean
+  // curvature terms to the vertex kernel
+  isBendingTermsCurrent = instructionSet != simd::InstructionSet::Scalar;
+  if (isBendingTermsCurrent)
+    computeBatchedVariationalVectors(activeForceTerms);
+  else
+    computeVariationalVectors(activeForceTerms);
+
+  // vertexwise computation only writes to the slot of its own vertex, hence
+  // the threaded loop is bitwise identical to the serial one
+  const MechanicalForcesKernel kernel = getMechanicalForcesKernel();
+  const std::ptrdiff_t nVertices = mesh->nVertices();
+  const bool isEnergySweep = isVertexEnergySweep;
+  if (isEnergySweep)
+    vertexEnergies.resize(nVertices, 5);
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+    (this->*kernel)(static_cast<std::size_t>(i));
+    if (isEnergySweep)
+      computeVertexEnergies(static_cast<std::size_t>(i));
   }
+  isBendingTermsCurrent = false;
 
   // measure smoothness
   // if (meshProcessor.meshMutator.isSplitEdge ||
@@ -261,7 +611,30 @@ void System::computeMechanicalForces(gcs::Vertex &v) {
 }
 
 void System::computeMechanicalForces(size_t i) {
-  gc::Vertex v{mesh->vertex(i)};
+  (this->*getMechanicalForcesKernel())(i);
+}
+
+void System::computeMechanicalForces(const std::vector<std::size_t> &vertices) {
+  const MechanicalForcesKernel kernel = getMechanicalForcesKernel();
+  const std::ptrdiff_t nVertices = vertices.size();
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t n = 0; n < nVertices; ++n) {
+    (this->*kernel)(vertices[n]);
+  }
+}
+
+template <unsigned ForceTerms, bool IsOpenMesh>
+void System::computeMechanicalForcesKernel(std::size_t i) {
+  constexpr bool isBending = ForceTerms & BENDING;
+  constexpr bool isDeviatoric = ForceTerms & DEVIATORIC;
+  constexpr bool isAdsorption = ForceTerms & ADSORPTION;
+  constexpr bool isAggregation = ForceTerms & AGGREGATION;
+  constexpr bool isLineTension = ForceTerms & LINE_TENSION;
+
+  const VariationalVectors &vv = variationalVectors;
+  const Connectivity &cn = connectivity;
   gc::Vector3 bendingForceVec{0, 0, 0};
   gc::Vector3 bendingForceVec_areaGrad{0, 0, 0};
   gc::Vector3 bendingForceVec_gaussVec{0, 0, 0};
@@ -271,109 +644,117 @@ void System::computeMechanicalForces(size_t i) {
   gc::Vector3 deviatoricForceVec_mean{0, 0, 0};
   gc::Vector3 deviatoricForceVec_gauss{0, 0, 0};
 
-  gc::Vector3 capillaryForceVec{0, 0, 0};
-  gc::Vector3 osmoticForceVec{0, 0, 0};
+  gc::Vector3 areaGradientVec{0, 0, 0};
+  gc::Vector3 volumeGradientVec{0, 0, 0};
   gc::Vector3 lineCapForceVec{0, 0, 0};
   gc::Vector3 adsorptionForceVec{0, 0, 0};
   gc::Vector3 aggregationForceVec{0, 0, 0};
-  double Hi = vpg->vertexMeanCurvatures[i] / vpg->vertexDualAreas[i];
+  double Hi = vv.meanCurvature[i];
   double H0i = H0[i];
   double Kbi = Kb[i];
   double Kdi = Kd[i];
   double proteinDensityi = proteinDensity[i];
-  bool boundaryVertex = v.isBoundary();
+  bool boundaryVertex = IsOpenMesh && cn.isBoundaryVertex(i);
+  const bool isBendingTerms = isBendingTermsCurrent;
 
-  for (gc::Halfedge he : v.outgoingHalfedges()) {
-    std::size_t fID = he.face().getIndex();
+  for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+       ++k) {
+    std::size_t he = cn.outgoingHalfedges[k];
+    std::size_t he_next = cn.halfedgeNext[he];
+    std::size_t he_twin = cn.halfedgeTwin[he];
+    std::size_t he_twin_next_next = cn.halfedgeNext[cn.halfedgeNext[he_twin]];
+    std::size_t fID = cn.halfedgeFace[he];
 
     // Initialize local variables for computation
-    std::size_t i_vj = he.tipVertex().getIndex();
-
-    gc::Vector3 dphi_ijk{he.isInterior() ? proteinDensityGradient[fID]
-                                         : gc::Vector3{0, 0, 0}};
-    double Hj = vpg->vertexMeanCurvatures[i_vj] / vpg->vertexDualAreas[i_vj];
-    double H0j = H0[i_vj];
-    double Kbj = Kb[i_vj];
-    double Kdj = Kd[i_vj];
+    std::size_t i_vj = cn.halfedgeTip[he];
     double proteinDensityj = proteinDensity[i_vj];
-    bool interiorHalfedge = he.isInterior();
-    bool boundaryEdge = he.edge().isBoundary();
-    bool boundaryNeighborVertex = he.next().vertex().isBoundary();
-
-    gc::Vector3 areaGrad = 2 * computeHalfedgeMeanCurvatureVector(*vpg, he);
-    gc::Vector3 gaussVec = computeHalfedgeGaussianCurvatureVector(*vpg, he);
-    gc::Vector3 schlafliVec1;
-    gc::Vector3 schlafliVec2;
-    // std::tie(schlafliVec1, schlafliVec2) =
-    //     computeHalfedgeSchlafliVector(*vpg, he);
-    schlafliVec1 =
-        vpg->edgeLengths[he.edge()] * dihedralAngleGradient(he, he.vertex());
-    schlafliVec2 =
-        vpg->edgeLengths[he.twin().edge()] *
-            dihedralAngleGradient(he.twin(), he.vertex()) +
-        vpg->edgeLengths[he.next().edge()] *
-            dihedralAngleGradient(he.next(), he.vertex()) +
-        vpg->edgeLengths[he.twin().next().next().edge()] *
-            dihedralAngleGradient(he.twin().next().next(), he.vertex());
-    gc::Vector3 oneSidedAreaGrad{0, 0, 0};
-    gc::Vector3 dirichletVec{0, 0, 0};
-    if (interiorHalfedge) {
-      oneSidedAreaGrad = 0.5 * gc::cross(vpg->faceNormals[fID],
-                                         vecFromHalfedge(he.next(), *vpg));
-      dirichletVec = computeGradientNorm2Gradient(he, proteinDensity) /
-                     vpg->faceAreas[fID];
-    }
+    gc::Vector3 areaGrad = vv.areaGradient[he];
 
     // Assemble to forces
-    osmoticForceVec +=
-        forces.osmoticPressure * computeHalfedgeVolumeVariationVector(*vpg, he);
-    capillaryForceVec -= forces.surfaceTension * areaGrad;
-    adsorptionForceVec -= (proteinDensityi / 3 + proteinDensityj * 2 / 3) *
-                          parameters.adsorption.epsilon * areaGrad;
-    aggregationForceVec -= (proteinDensityi * proteinDensityi / 3 +
-                            proteinDensityj * proteinDensityj * 2 / 3) *
-                           parameters.aggregation.chi * areaGrad;
-    lineCapForceVec -=
-        parameters.dirichlet.eta *
-        (0.125 * dirichletVec - 0.5 * dphi_ijk.norm2() * oneSidedAreaGrad);
-
-    bendingForceVec_schlafliVec -=
-        (Kbi * (Hi - H0i) * schlafliVec1 + Kbj * (Hj - H0j) * schlafliVec2);
-    bendingForceVec_areaGrad -= (Kbi * (H0i * H0i - Hi * Hi) / 3 +
-                                 Kbj * (H0j * H0j - Hj * Hj) * 2 / 3) *
-                                areaGrad;
-    bendingForceVec_gaussVec -=
-        (Kbi * (Hi - H0i) + Kbj * (Hj - H0j)) * gaussVec;
-
-    deviatoricForceVec_mean -=
-        (Kdi * Hi + Kdj * Hj) * gaussVec +
-        (Kdi * (-Hi * Hi) / 3 + Kdj * (-Hj * Hj) * 2 / 3) * areaGrad +
-        (Kdi * Hi * schlafliVec1 + Kdj * Hj * schlafliVec2);
-
-    // bool interiorTwinHalfedge = he.twin().isInterior();
-    // if (interiorHalfedge) {
-    //   deviatoricForceVec_gauss -=
-    //       Kdi * cornerAngleGradient(he.corner(), he.vertex()) +
-    //       Kdj * cornerAngleGradient(he.next().corner(), he.vertex());
-    // }
-    // if (interiorTwinHalfedge) {
-    //   deviatoricForceVec_gauss -=
-    //       Kdj * cornerAngleGradient(he.twin().corner(), he.vertex());
-    // }
-    if (boundaryVertex) {
-      if (!boundaryEdge)
-        deviatoricForceVec_gauss -=
-            Kdj * cornerAngleGradient(he.next().corner(), he.vertex()) +
-            Kdj * cornerAngleGradient(he.twin().corner(), he.vertex());
+    volumeGradientVec += vv.volumeVariationVector[he];
+    areaGradientVec += areaGrad;
+    if (isAdsorption) {
+      adsorptionForceVec -= (proteinDensityi / 3 + proteinDensityj * 2 / 3) *
+                            parameters.adsorption.epsilon * areaGrad;
+    }
+    if (isAggregation) {
+      aggregationForceVec -= (proteinDensityi * proteinDensityi / 3 +
+                              proteinDensityj * proteinDensityj * 2 / 3) *
+                             parameters.aggregation.chi * areaGrad;
+    }
+    if (isLineTension) {
+      gc::Vector3 dphi_ijk{(!IsOpenMesh || cn.isInterior(he))
+                               ? proteinDensityGradient[fID]
+                               : gc::Vector3{0, 0, 0}};
+      lineCapForceVec -= parameters.dirichlet.eta *
+                         (0.125 * vv.dirichletVector[he] -
+                          0.5 * dphi_ijk.norm2() * vv.oneSidedAreaGradient[he]);
+    }
+
+    if (!isBending && !isDeviatoric)
+      continue;
+
+    if (isBendingTerms) {
+      // halfedge terms of the vectorized bending stage
+      const simd::BendingTerms &terms = bendingTerms[k];
+      if (isBending) {
+        bendingForceVec_schlafliVec += terms.schlafli;
+        bendingForceVec_areaGrad += terms.areaGrad;
+        bendingForceVec_gaussVec += terms.gauss;
+      }
+      if (isDeviatoric)
+        deviatoricForceVec_mean += terms.deviatoricMean;
     } else {
-      if (boundaryNeighborVertex) {
-        deviatoricForceVec_gauss -=
-            Kdi * cornerAngleGradient(he.corner(), he.vertex());
+      double Hj = vv.meanCurvature[i_vj];
+      gc::Vector3 gaussVec = vv.gaussianCurvatureVector[he];
+      gc::Vector3 schlafliVec1 = vv.dihedralGradientTail[he];
+      gc::Vector3 schlafliVec2 =
+          vv.dihedralGradientTail[he] + vv.dihedralGradientOpposite[he_next] +
+          vv.dihedralGradientOpposite[he_twin_next_next];
+
+      if (isBending) {
+        double H0j = H0[i_vj];
+        double Kbj = Kb[i_vj];
+        bendingForceVec_schlafliVec -= (Kbi * (Hi - H0i) * schlafliVec1 +
+                                        Kbj * (Hj - H0j) * schlafliVec2);
+        bendingForceVec_areaGrad -= (Kbi * (H0i * H0i - Hi * Hi) / 3 +
+                                     Kbj * (H0j * H0j - Hj * Hj) * 2 / 3) *
+                                    areaGrad;
+        bendingForceVec_gaussVec -=
+            (Kbi * (Hi - H0i) + Kbj * (Hj - H0j)) * gaussVec;
+      }
+
+      if (isDeviatoric) {
+        double Kdj = Kd[i_vj];
+        deviatoricForceVec_mean -=
+            (Kdi * Hi + Kdj * Hj) * gaussVec +
+            (Kdi * (-Hi * Hi) / 3 + Kdj * (-Hj * Hj) * 2 / 3) * areaGrad +
+            (Kdi * Hi * schlafliVec1 + Kdj * Hj * schlafliVec2);
+      }
+    }
+
+    if (isDeviatoric) {
+      double Kdj = Kd[i_vj];
+      bool boundaryEdge = IsOpenMesh && cn.isBoundaryEdge(he);
+      bool boundaryNeighborVertex = IsOpenMesh && cn.isBoundaryVertex(i_vj);
+
+      // corner angle gradients wrt vi: corner of he at vi, corner of
+      // he.next() at vj (vi opposite) and corner of he.twin() at vj (vi as
+      // tip)
+      if (boundaryVertex) {
+        if (!boundaryEdge)
+          deviatoricForceVec_gauss -=
+              Kdj * vv.cornerAngleGradientOpposite[he_next] +
+              Kdj * vv.cornerAngleGradientTip[he_twin];
       } else {
-        deviatoricForceVec_gauss -=
-            Kdi * cornerAngleGradient(he.corner(), he.vertex()) +
-            Kdj * cornerAngleGradient(he.next().corner(), he.vertex()) +
-            Kdj * cornerAngleGradient(he.twin().corner(), he.vertex());
+        if (boundaryNeighborVertex) {
+          deviatoricForceVec_gauss -= Kdi * vv.cornerAngleGradientSelf[he];
+        } else {
+          deviatoricForceVec_gauss -=
+              Kdi * vv.cornerAngleGradientSelf[he] +
+              Kdj * vv.cornerAngleGradientOpposite[he_next] +
+              Kdj * vv.cornerAngleGradientTip[he_twin];
+        }
       }
     }
   }
@@ -381,11 +762,26 @@ void System::computeMechanicalForces(size_t i) {
   bendingForceVec = bendingForceVec_areaGrad + bendingForceVec_gaussVec +
                     bendingForceVec_schlafliVec;
 
+  // the global tension and pressure scale the cached gradients, such that
+  // updateMutatedConfigurations can rescale them away from the mutation
+  gc::Vector3 osmoticForceVec = forces.osmoticPressure * volumeGradientVec;
+  gc::Vector3 capillaryForceVec = -forces.surfaceTension * areaGradientVec;
+
   // deviatoricForceVec = deviatoricForceVec_gauss;
   // std::cout << "gauss force: " << deviatoricForceVec_gauss << std::ends;
   deviatoricForceVec = deviatoricForceVec_mean + deviatoricForceVec_gauss;
   // deviatoricForceVec = deviatoricForceVec_mean;
 
+  // lean mode: only the sum, in the order of computePhysicalForcing, is stored
+  if (!isDecomposeForces) {
+    forces.mechanicalForceVec[i] = forces.maskForce(
+        osmoticForceVec + capillaryForceVec + bendingForceVec +
+            deviatoricForceVec + lineCapForceVec + adsorptionForceVec +
+            aggregationForceVec,
+        i);
+    return;
+  }
+
   // masking
   bendingForceVec_areaGrad = forces.maskForce(bendingForceVec_areaGrad, i);
   bendingForceVec_gaussVec = forces.maskForce(bendingForceVec_gaussVec, i);
@@ -397,6 +793,8 @@ void System::computeMechanicalForces(size_t i) {
   deviatoricForceVec_gauss = forces.maskForce(deviatoricForceVec_gauss, i);
   deviatoricForceVec = forces.maskForce(deviatoricForceVec, i);
 
+  areaGradientVec = forces.maskForce(areaGradientVec, i);
+  volumeGradientVec = forces.maskForce(volumeGradientVec, i);
   osmoticForceVec = forces.maskForce(osmoticForceVec, i);
   capillaryForceVec = forces.maskForce(capillaryForceVec, i);
   lineCapForceVec = forces.maskForce(lineCapForceVec, i);
@@ -415,6 +813,8 @@ void System::computeMechanicalForces(size_t i) {
 
   forces.capillaryForceVec[i] = capillaryForceVec;
   forces.osmoticForceVec[i] = osmoticForceVec;
+  forces.areaGradientVec[i] = areaGradientVec;
+  forces.volumeGradientVec[i] = volumeGradientVec;
   forces.lineCapillaryForceVec[i] = lineCapForceVec;
   forces.adsorptionForceVec[i] = adsorptionForceVec;
   forces.aggregationForceVec[i] = aggregationForceVec;
@@ -429,6 +829,45 @@ void System::computeMechanicalForces(size_t i) {
   forces.aggregationForce[i] = forces.ontoNormal(aggregationForceVec, i);
 }
 
+void System::computeVectorizedBendingForces() {
+  const Connectivity &cn = connectivity;
+
+  computeBatchedVariationalVectors(BENDING | DEVIATORIC);
+
+  // reduce to vertices in the same order as computeMechanicalForces(i)
+  const std::ptrdiff_t nVertices = mesh->nVertices();
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+    gc::Vector3 bendingForceVec_areaGrad{0, 0, 0};
+    gc::Vector3 bendingForceVec_gaussVec{0, 0, 0};
+    gc::Vector3 bendingForceVec_schlafliVec{0, 0, 0};
+    gc::Vector3 deviatoricForceVec_mean{0, 0, 0};
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k) {
+      bendingForceVec_schlafliVec += bendingTerms[k].schlafli;
+      bendingForceVec_areaGrad += bendingTerms[k].areaGrad;
+      bendingForceVec_gaussVec += bendingTerms[k].gauss;
+      deviatoricForceVec_mean += bendingTerms[k].deviatoricMean;
+    }
+    gc::Vector3 bendingForceVec = bendingForceVec_areaGrad +
+                                  bendingForceVec_gaussVec +
+                                  bendingForceVec_schlafliVec;
+
+    forces.bendingForceVec_areaGrad[i] =
+        forces.maskForce(bendingForceVec_areaGrad, i);
+    forces.bendingForceVec_gaussVec[i] =
+        forces.maskForce(bendingForceVec_gaussVec, i);
+    forces.bendingForceVec_schlafliVec[i] =
+        forces.maskForce(bendingForceVec_schlafliVec, i);
+    forces.bendingForceVec[i] = forces.maskForce(bendingForceVec, i);
+    forces.deviatoricForceVec_mean[i] =
+        forces.maskForce(deviatoricForceVec_mean, i);
+    forces.bendingForce[i] = forces.ontoNormal(forces.bendingForceVec[i], i);
+  }
+}
+
 EigenVectorX3dr System::prescribeExternalForce() {
 #define MODE 1
 #if MODE == 0 // axial sinusoidal force
@@ -464,8 +903,7 @@ EigenVectorX3dr System::prescribeExternalForce() {
 
 #elif MODE == 2 // anchor force
   double decayTime = 500;
-  gcs::HeatMethodDistanceSolver heatSolver(*vpg);
-  geodesicDistanceFromPtInd = heatSolver.computeDistance(thePoint);
+  updateGeodesicDistance(true);
   double standardDeviation = 0.02;
 
   // gc::Vector3 anchor{0, 0, 1};
@@ -486,37 +924,282 @@ EigenVectorX3dr System::prescribeExternalForce() {
   return toMatrix(forces.externalForceVec);
 }
 
+void System::updateSelfAvoidanceExclusions() {
+  const std::size_t n = parameters.selfAvoidance.n;
+  if (isSelfAvoidanceExclusionsCurrent && selfAvoidanceExclusionLayers == n &&
+      selfAvoidanceExclusionOffsets.size() == mesh->nVertices() + 1)
+    return;
+
+  selfAvoidanceExclusionOffsets.assign(1, 0);
+  selfAvoidanceExclusions.clear();
+  std::vector<std::size_t> neighbors;
+  for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
+    gc::Vertex vi{mesh->vertex(i)};
+    neighbors.clear();
+    if (n > 0) {
+      for (gc::Vertex nv : vi.adjacentVertices()) {
+        neighbors.push_back(nv.getIndex());
+        if (n > 1) {
+          for (gc::Vertex nnv : nv.adjacentVertices())
+            neighbors.push_back(nnv.getIndex());
+        }
+      }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    auto last = std::unique(neighbors.begin(), neighbors.end());
+    for (auto j = std::upper_bound(neighbors.begin(), last, i); j != last; ++j)
+      selfAvoidanceExclusions.push_back(*j);
+    selfAvoidanceExclusionOffsets.push_back(selfAvoidanceExclusions.size());
+  }
+  selfAvoidanceExclusionLayers = n;
+  isSelfAvoidanceExclusionsCurrent = true;
+}
+
+bool System::isSelfAvoidanceExcluded(std::size_t i, std::size_t j) const {
+  if (i == j)
+    return true;
+  if (i > j)
+    std::swap(i, j);
+  return std::binary_search(
+      selfAvoidanceExclusions.begin() + selfAvoidanceExclusionOffsets[i],
+      selfAvoidanceExclusions.begin() + selfAvoidanceExclusionOffsets[i + 1],
+      j);
+}
+
+double System::computeSelfAvoidanceExclusionRadius() const {
+  double maxLength2 = 0;
+  for (gc::Edge e : mesh->edges())
+    maxLength2 = std::max(
+        maxLength2, gc::norm2(vpg->inputVertexPositions[e.firstVertex()] -
+                              vpg->inputVertexPositions[e.secondVertex()]));
+  return std::max(parameters.selfAvoidance.d,
+                  parameters.selfAvoidance.n * std::sqrt(maxLength2));
+}
+
+void System::findSelfAvoidancePairs() {
+  const double cutoff = parameters.selfAvoidance.cutoff;
+  const double skin = parameters.selfAvoidance.skin;
+  const double range = cutoff + skin;
+
+  // two vertices approach by at most a skin before either of them moves by
+  // half the skin, so the Verlet list still holds all pairs within cutoff
+  bool isRebuild =
+      !isSelfAvoidanceVerletListCurrent || range != selfAvoidanceVerletRange ||
+      static_cast<std::size_t>(selfAvoidanceVerletPositions.rows()) !=
+          mesh->nVertices();
+  if (!isRebuild) {
+    double maxDisplacement2 = (toMatrix(vpg->inputVertexPositions) -
+                               selfAvoidanceVerletPositions)
+                                  .rowwise()
+                                  .squaredNorm()
+                                  .maxCoeff();
+    isRebuild = 4 * maxDisplacement2 > skin * skin;
+  }
+  if (isRebuild) {
+    spatialHash.build(vpg->inputVertexPositions, range);
+    spatialHash.findPairs(vpg->inputVertexPositions, range,
+                          selfAvoidanceVerletPairs);
+    selfAvoidanceVerletPositions = toMatrix(vpg->inputVertexPositions);
+    selfAvoidanceVerletRange = range;
+    isSelfAvoidanceVerletListCurrent = true;
+    ++selfAvoidanceRebuildCount;
+  }
+
+  // exclude the neighborhood layers and the pairs beyond the cutoff, both the
+  // pairs and the exclusions are in ascending order
+  updateSelfAvoidanceExclusions();
+  selfAvoidancePairs.clear();
+  std::size_t k = 0;
+  for (const SpatialHash::Pair &ij : selfAvoidanceVerletPairs) {
+    std::size_t end = selfAvoidanceExclusionOffsets[ij.first + 1];
+    k = std::max(k, selfAvoidanceExclusionOffsets[ij.first]);
+    while (k < end && selfAvoidanceExclusions[k] < ij.second)
+      ++k;
+    if ((k == end || selfAvoidanceExclusions[k] != ij.second) &&
+        gc::norm2(vpg->inputVertexPositions[ij.second] -
+                  vpg->inputVertexPositions[ij.first]) < cutoff * cutoff)
+      selfAvoidancePairs.push_back(ij);
+  }
+}
+
+void System::findSelfContacts() {
+  const double cutoff = parameters.selfAvoidance.cutoff;
+  if (!connectivity.isCurrent(*mesh))
+    connectivity.build(*mesh);
+  const Connectivity &cn = connectivity;
+  const gcs::VertexData<gc::Vector3> &pos = vpg->inputVertexPositions;
+  if (isFaceBVHCurrent && faceBVH.faces.size() == cn.nFaces) {
+    faceBVH.refit(cn, pos, nThreads);
+  } else {
+    faceBVH.build(cn, pos, nThreads);
+    isFaceBVHCurrent = true;
+  }
+  updateSelfAvoidanceExclusions();
+  selfContacts.clear();
+  const gc::Vector3 margin{cutoff, cutoff, cutoff};
+
+  // a closest point on a shared edge or vertex is found from every incident
+  // primitive, so keep one contact per pair of closest features, weighted by
+  // the mean densities of the features
+  std::set<std::array<std::size_t, 6>> features;
+  auto addContact = [&](const Proximity &contact) {
+    if (!features.insert(closestFeatures(contact)).second)
+      return;
+    double phi1 = 0, phi2 = 0;
+    std::size_t n1 = 0, n2 = 0;
+    for (std::size_t k = 0; k < 4; ++k) {
+      if (contact.coefficients[k] > 0) {
+        phi1 += proteinDensity[contact.vertices[k]];
+        ++n1;
+      } else if (contact.coefficients[k] < 0) {
+        phi2 += proteinDensity[contact.vertices[k]];
+        ++n2;
+      }
+    }
+    selfContacts.push_back(contact);
+    selfContacts.back().weight = phi1 / n1 * phi2 / n2;
+  };
+
+  // vertex-face
+  for (std::size_t i = 0; i < cn.nVertices; ++i) {
+    const gc::Vector3 &x = pos[i];
+    faceBVH.query(x - margin, x + margin, [&](std::size_t f) {
+      std::array<std::size_t, 3> v = FaceBVH::faceVertices(cn, f);
+      for (std::size_t j : v) {
+        if (isSelfAvoidanceExcluded(i, j))
+          return;
+      }
+      std::array<double, 3> b;
+      gc::Vector3 difference =
+          x - closestPointOnTriangle(x, pos[v[0]], pos[v[1]], pos[v[2]], b);
+      if (gc::norm2(difference) < cutoff * cutoff)
+        addContact(
+            {{i, v[0], v[1], v[2]}, {1, -b[0], -b[1], -b[2]}, difference, 0});
+    });
+  }
+
+  // edge-edge, each pair is found from the edge of lower index
+  std::vector<std::size_t> candidates;
+  for (std::size_t e = 0; e < cn.nEdges; ++e) {
+    const std::size_t i1 = cn.halfedgeTail[cn.edgeHalfedge[e]];
+    const std::size_t i2 = cn.halfedgeTip[cn.edgeHalfedge[e]];
+    const gc::Vector3 &p1 = pos[i1], &q1 = pos[i2];
+    gc::Vector3 lower{std::min(p1.x, q1.x), std::min(p1.y, q1.y),
+                      std::min(p1.z, q1.z)};
+    gc::Vector3 upper{std::max(p1.x, q1.x), std::max(p1.y, q1.y),
+                      std::max(p1.z, q1.z)};
+    candidates.clear();
+    faceBVH.query(lower - margin, upper + margin, [&](std::size_t f) {
+      std::size_t he = cn.faceHalfedge[f];
+      for (std::size_t k = 0; k < 3; ++k, he = cn.halfedgeNext[he]) {
+        if (cn.halfedgeEdge[he] > e)
+          candidates.push_back(cn.halfedgeEdge[he]);
+      }
+    });
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+
+    for (std::size_t e2 : candidates) {
+      const std::size_t j1 = cn.halfedgeTail[cn.edgeHalfedge[e2]];
+      const std::size_t j2 = cn.halfedgeTip[cn.edgeHalfedge[e2]];
+      if (isSelfAvoidanceExcluded(i1, j1) || isSelfAvoidanceExcluded(i1, j2) ||
+          isSelfAvoidanceExcluded(i2, j1) || isSelfAvoidanceExcluded(i2, j2))
+        continue;
+      double s, t;
+      closestPointsOnSegments(p1, q1, pos[j1], pos[j2], s, t);
+      gc::Vector3 difference =
+          (1 - s) * p1 + s * q1 - (1 - t) * pos[j1] - t * pos[j2];
+      if (gc::norm2(difference) < cutoff * cutoff)
+        addContact({{i1, i2, j1, j2}, {1 - s, s, -(1 - t), -t}, difference, 0});
+    }
+  }
+}
+
 void System::computeSelfAvoidanceForce() {
   forces.selfAvoidanceForceVec.fill({0, 0, 0});
   const double d0 = parameters.selfAvoidance.d;
   const double mu = parameters.selfAvoidance.mu;
-  const double n = parameters.selfAvoidance.n;
-  for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
+  auto addPairForce = [&](std::size_t i, std::size_t j) {
     gc::Vertex vi{mesh->vertex(i)};
-    gc::VertexData<bool> neighborList(*mesh, false);
-    meshProcessor.meshMutator.markVertices(neighborList, vi, n);
-    for (std::size_t j = i + 1; j < mesh->nVertices(); ++j) {
-      if (neighborList[j])
-        continue;
-      gc::Vertex vj{mesh->vertex(j)};
-      // double penalty = mu * vpg->vertexDualAreas[vi] * proteinDensity[vi] *
-      //                  vpg->vertexDualAreas[vj] * proteinDensity[vj];
-      double penalty = mu * proteinDensity[vi] * proteinDensity[vj];
-      // double penalty = mu;
-      // double penalty = mu * vpg->vertexDualAreas[vi] *
-      // vpg->vertexDualAreas[vj];;
-      gc::Vector3 r =
-          vpg->inputVertexPositions[vj] - vpg->inputVertexPositions[vi];
-      double distance = gc::norm(r) - d0;
-      gc::Vector3 grad = r.normalize();
-      // forces.selfAvoidanceForceVec[i] -=
-      //     forces.maskForce(penalty / distance * grad, i);
-      // forces.selfAvoidanceForceVec[j] +=
-      //     forces.maskForce(penalty / distance * grad, j);
-      forces.selfAvoidanceForceVec[i] -=
-          forces.maskForce(penalty / distance / distance * grad, i);
-      forces.selfAvoidanceForceVec[j] +=
-          forces.maskForce(penalty / distance / distance * grad, j);
+    gc::Vertex vj{mesh->vertex(j)};
+    // double penalty = mu * vpg->vertexDualAreas[vi] * proteinDensity[vi] *
+    //                  vpg->vertexDualAreas[vj] * proteinDensity[vj];
+    double penalty = mu * proteinDensity[vi] * proteinDensity[vj];
+    // double penalty = mu;
+    // double penalty = mu * vpg->vertexDualAreas[vi] *
+    // vpg->vertexDualAreas[vj];;
+    gc::Vector3 r =
+        vpg->inputVertexPositions[vj] - vpg->inputVertexPositions[vi];
+    double distance = gc::norm(r) - d0;
+    gc::Vector3 grad = r.normalize();
+    // forces.selfAvoidanceForceVec[i] -=
+    //     forces.maskForce(penalty / distance * grad, i);
+    // forces.selfAvoidanceForceVec[j] +=
+    //     forces.maskForce(penalty / distance * grad, j);
+    forces.selfAvoidanceForceVec[i] -=
+        forces.maskForce(penalty / distance / distance * grad, i);
+    forces.selfAvoidanceForceVec[j] +=
+        forces.maskForce(penalty / distance / distance * grad, j);
+  };
+
+  if (parameters.selfAvoidance.isFaceContact) {
+    findSelfContacts();
+    for (const Proximity &contact : selfContacts) {
+      double distance = gc::norm(contact.difference) - d0;
+      gc::Vector3 grad = gc::unit(contact.difference);
+      double magnitude = mu * contact.weight / distance / distance;
+      for (std::size_t k = 0; k < 4; ++k) {
+        std::size_t v = contact.vertices[k];
+        forces.selfAvoidanceForceVec[v] += forces.maskForce(
+            magnitude * contact.coefficients[k] * grad, v);
+      }
+    }
+  } else if (parameters.selfAvoidance.cutoff > 0) {
+    findSelfAvoidancePairs();
+    for (const SpatialHash::Pair &ij : selfAvoidancePairs)
+      addPairForce(ij.first, ij.second);
+  } else if (parameters.selfAvoidance.theta > 0) {
+    // far field monopoles lie beyond the exclusion radius, so that they
+    // contain no excluded neighbor and stay farther than d
+    const double theta = parameters.selfAvoidance.theta;
+    const double radius = computeSelfAvoidanceExclusionRadius();
+    updateSelfAvoidanceExclusions();
+    octree.build(vpg->inputVertexPositions, proteinDensity);
+    const std::ptrdiff_t nVertices = mesh->nVertices();
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(dynamic, 64)                                 \
+    num_threads(getNumThreads(nThreads))
+#endif
+    for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+      const gc::Vector3 &xi = vpg->inputVertexPositions[i];
+      gc::Vector3 force{0, 0, 0};
+      auto addMonopoleForce = [&](const gc::Vector3 &xj, double phij) {
+        gc::Vector3 r = xj - xi;
+        double distance = gc::norm(r) - d0;
+        double penalty = mu * proteinDensity[i] * phij;
+        force -= penalty / distance / distance * r.normalize();
+      };
+      octree.traverse(
+          xi, theta, radius,
+          [&](std::size_t j) {
+            if (!isSelfAvoidanceExcluded(i, j))
+              addMonopoleForce(vpg->inputVertexPositions[j], proteinDensity[j]);
+          },
+          addMonopoleForce);
+      forces.selfAvoidanceForceVec[i] = forces.maskForce(force, i);
+    }
+  } else {
+    updateSelfAvoidanceExclusions();
+    for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
+      std::size_t k = selfAvoidanceExclusionOffsets[i];
+      for (std::size_t j = i + 1; j < mesh->nVertices(); ++j) {
+        if (k < selfAvoidanceExclusionOffsets[i + 1] &&
+            selfAvoidanceExclusions[k] == j)
+          ++k;
+        else
+          addPairForce(i, j);
+      }
     }
   }
   forces.selfAvoidanceForce = forces.ontoNormal(forces.selfAvoidanceForceVec);
@@ -582,9 +1265,13 @@ void System::computeChemicalPotentials() {
   //   forces.aggregationPotential.raw() = forces.maskProtein(
   //       -2 * parameters.aggregation.chi * proteinDensity.raw().array());
 
-  if (parameters.dirichlet.eta != 0)
-    forces.diffusionPotential.raw() = forces.maskProtein(
-        -parameters.dirichlet.eta * vpg->cotanLaplacian * proteinDensity.raw());
+  if (parameters.dirichlet.eta != 0) {
+    if (!isCotanLaplacianPatternCurrent)
+      updateCotanLaplacian();
+    forces.diffusionPotential.raw() =
+        forces.maskProtein(-parameters.dirichlet.eta * cotanLaplacian.matrix *
+                           proteinDensity.raw());
+  }
 
   if (parameters.proteinDistribution.lambdaPhi != 0)
     forces.interiorPenaltyPotential.raw() =
@@ -723,7 +1410,12 @@ double System::computeNorm(
   //        rowwiseProduct(mask, vpg->vertexDualAreas.raw()).sum();
 
   // return force.lpNorm<1>();
-  return force.norm();
+
+  // reproducible for any number of threads
+  return std::sqrt(parallelSum(
+      force.size(),
+      [&force](std::size_t k) { return force.data()[k] * force.data()[k]; },
+      nThreads));
 }
 
 double System::computeNorm(
@@ -736,26 +1428,22 @@ double System::computeNorm(
   // L1 Norm
   // return force.lpNorm<1>();
 
-  return force.norm();
+  // reproducible for any number of threads
+  return std::sqrt(parallelSum(
+      force.size(),
+      [&force](std::size_t k) { return force.data()[k] * force.data()[k]; },
+      nThreads));
 }
 
 void System::computePhysicalForcing() {
+  // mechanical forces of updateMutatedConfigurations are reused once
+  const bool isMechanicalForcesCurrent_ =
+      isMechanicalForcesCurrent && parameters.variation.isShapeVariation;
+  isMechanicalForcesCurrent = false;
 
   // zero all forces
-  forces.mechanicalForceVec.fill({0, 0, 0});
-
-  forces.bendingForceVec.fill({0, 0, 0});
-  forces.bendingForceVec_areaGrad.fill({0, 0, 0});
-  forces.bendingForceVec_gaussVec.fill({0, 0, 0});
-  forces.bendingForceVec_schlafliVec.fill({0, 0, 0});
-
-  forces.deviatoricForceVec.fill({0, 0, 0});
-
-  forces.capillaryForceVec.fill({0, 0, 0});
-  forces.osmoticForceVec.fill({0, 0, 0});
-  forces.lineCapillaryForceVec.fill({0, 0, 0});
-  forces.adsorptionForceVec.fill({0, 0, 0});
-  forces.aggregationForceVec.fill({0, 0, 0});
+  if (!isMechanicalForcesCurrent_)
+    forces.mechanicalForceVec.fill({0, 0, 0});
   forces.externalForceVec.fill({0, 0, 0});
   forces.selfAvoidanceForceVec.fill({0, 0, 0});
 
@@ -763,16 +1451,33 @@ void System::computePhysicalForcing() {
   forces.stochasticForceVec.fill({0, 0, 0});
 
   forces.mechanicalForce.raw().setZero();
-  forces.bendingForce.raw().setZero();
-  forces.deviatoricForce.raw().setZero();
-  forces.capillaryForce.raw().setZero();
-  forces.lineCapillaryForce.raw().setZero();
   forces.externalForce.raw().setZero();
-  forces.adsorptionForce.raw().setZero();
-  forces.aggregationForce.raw().setZero();
-  forces.osmoticForce.raw().setZero();
   forces.selfAvoidanceForce.raw().setZero();
 
+  // decomposed components are left untouched in lean mode
+  if (isDecomposeForces && !isMechanicalForcesCurrent_) {
+    forces.bendingForceVec.fill({0, 0, 0});
+    forces.bendingForceVec_areaGrad.fill({0, 0, 0});
+    forces.bendingForceVec_gaussVec.fill({0, 0, 0});
+    forces.bendingForceVec_schlafliVec.fill({0, 0, 0});
+
+    forces.deviatoricForceVec.fill({0, 0, 0});
+
+    forces.capillaryForceVec.fill({0, 0, 0});
+    forces.osmoticForceVec.fill({0, 0, 0});
+    forces.lineCapillaryForceVec.fill({0, 0, 0});
+    forces.adsorptionForceVec.fill({0, 0, 0});
+    forces.aggregationForceVec.fill({0, 0, 0});
+
+    forces.bendingForce.raw().setZero();
+    forces.deviatoricForce.raw().setZero();
+    forces.capillaryForce.raw().setZero();
+    forces.lineCapillaryForce.raw().setZero();
+    forces.adsorptionForce.raw().setZero();
+    forces.aggregationForce.raw().setZero();
+    forces.osmoticForce.raw().setZero();
+  }
+
   forces.chemicalPotential.raw().setZero();
 
   forces.diffusionPotential.raw().setZero();
@@ -783,19 +1488,27 @@ void System::computePhysicalForcing() {
   forces.interiorPenaltyPotential.raw().setZero();
 
   if (parameters.variation.isShapeVariation) {
-    computeMechanicalForces();
+    if (!isMechanicalForcesCurrent_)
+      computeMechanicalForces();
     if (parameters.external.Kf != 0) {
       prescribeExternalForce();
     }
     if (parameters.selfAvoidance.mu != 0) {
       computeSelfAvoidanceForce();
     }
-    forces.mechanicalForceVec =
-        forces.osmoticForceVec + forces.capillaryForceVec +
-        forces.bendingForceVec + forces.deviatoricForceVec +
-        forces.lineCapillaryForceVec + forces.adsorptionForceVec +
-        forces.aggregationForceVec + forces.externalForceVec +
-        forces.selfAvoidanceForceVec;
+    if (isDecomposeForces) {
+      forces.mechanicalForceVec =
+          forces.osmoticForceVec + forces.capillaryForceVec +
+          forces.bendingForceVec + forces.deviatoricForceVec +
+          forces.lineCapillaryForceVec + forces.adsorptionForceVec +
+          forces.aggregationForceVec + forces.externalForceVec +
+          forces.selfAvoidanceForceVec;
+    } else {
+      // the membrane forces are already summed up by the kernel
+      forces.mechanicalForceVec = forces.mechanicalForceVec +
+                                  forces.externalForceVec +
+                                  forces.selfAvoidanceForceVec;
+    }
     if (parameters.damping != 0)
       forces.mechanicalForceVec += computeDampingForce();
     forces.mechanicalForce = forces.ontoNormal(forces.mechanicalForceVec);
@@ -820,6 +1533,15 @@ void System::computePhysicalForcing() {
                       : 0;
 }
 
+void System::computeDecomposedForces() {
+  if (!parameters.variation.isShapeVariation)
+    return;
+  bool isDecomposeForces_ = isDecomposeForces;
+  isDecomposeForces = true;
+  computeMechanicalForces();
+  isDecomposeForces = isDecomposeForces_;
+}
+
 void System::computePhysicalForcing(double timeStep) {
   computePhysicalForcing();
   if (parameters.variation.isShapeVariation && parameters.dpd.gamma != 0) {
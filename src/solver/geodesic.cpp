@@ -0,0 +1,298 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+
+#include "mem3dg/solver/geodesic.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "mem3dg/parallel.h"
+
+namespace mem3dg {
+namespace solver {
+
+/// Half of the cotangent of the angle opposite to the interior halfedge
+static double halfedgeCotanWeight(const Connectivity &cn, std::size_t he,
+                                  const gcs::VertexData<gc::Vector3> &pos) {
+  const gc::Vector3 &pC = pos[cn.halfedgeTip[cn.halfedgeNext[he]]];
+  gc::Vector3 u = pos[cn.halfedgeTail[he]] - pC;
+  gc::Vector3 v = pos[cn.halfedgeTip[he]] - pC;
+  return 0.5 * gc::dot(u, v) / gc::norm(gc::cross(u, v));
+}
+
+/// Distance of c from a point source through the planar unfolding of the
+/// triangle abc, given the distances of a and b, or from a or b along the
+/// edges if the straight path does not cross ab
+static double triangleUpdate(const gc::Vector3 &a, const gc::Vector3 &b,
+                             const gc::Vector3 &c, double distanceA,
+                             double distanceB) {
+  double dijkstra =
+      std::min(distanceA + gc::norm(c - a), distanceB + gc::norm(c - b));
+  // a at the origin, b on the x axis and c above, the source below
+  gc::Vector3 ab = b - a, ac = c - a;
+  double lengthAB = gc::norm(ab);
+  double cx = gc::dot(ac, ab) / lengthAB;
+  double cy = gc::norm(gc::cross(ac, ab)) / lengthAB;
+  double sx =
+      (distanceA * distanceA - distanceB * distanceB + lengthAB * lengthAB) /
+      (2 * lengthAB);
+  double sy2 = distanceA * distanceA - sx * sx;
+  if (sy2 < 0 || cy <= 0)
+    return dijkstra;
+  double sy = -std::sqrt(sy2);
+  double crossing = sx + (cx - sx) * (-sy) / (cy - sy);
+  if (crossing < 0 || crossing > lengthAB)
+    return dijkstra;
+  return std::min(dijkstra, std::hypot(cx - sx, cy - sy));
+}
+
+void GeodesicSolver::analyze(const Connectivity &cn) {
+  laplacian.build(cn);
+  heatSolver.analyzePattern(laplacian.matrix);
+  poissonSolver.analyzePattern(laplacian.matrix);
+  markedDistance = nullptr;
+  std::vector<Eigen::Triplet<double>> selection;
+  if (cn.hasBoundary) {
+    for (std::size_t i = 0; i < cn.nVertices; ++i) {
+      if (!cn.isBoundaryVertex(i))
+        selection.emplace_back(selection.size(), i, 1);
+    }
+  }
+  interiorSelection.resize(selection.size(), cn.nVertices);
+  interiorSelection.setFromTriplets(selection.begin(), selection.end());
+  if (interiorSelection.rows() > 0)
+    dirichletHeatSolver.analyzePattern(interiorSelection * laplacian.matrix *
+                                       interiorSelection.transpose());
+  isAnalyzed = true;
+  isFactorized = false;
+  ++nAnalyses;
+}
+
+void GeodesicSolver::factorize(const Connectivity &cn,
+                               const gcs::VertexData<gc::Vector3> &positions,
+                               std::size_t nThreads) {
+  const std::ptrdiff_t nEdges = cn.nEdges, nVertices = cn.nVertices;
+  Eigen::VectorXd edgeCotanWeights(nEdges), vertexDualAreas(nVertices);
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t e = 0; e < nEdges; ++e) {
+    std::size_t he = cn.edgeHalfedge[e];
+    double weight = 0;
+    for (std::size_t k : {he, cn.halfedgeTwin[he]}) {
+      if (cn.isInterior(k))
+        weight += halfedgeCotanWeight(cn, k, positions);
+    }
+    edgeCotanWeights[e] = weight;
+  }
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+    double dualArea = 0;
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k) {
+      std::size_t he = cn.outgoingHalfedges[k];
+      if (cn.isInterior(he))
+        dualArea += cn.faceArea(cn.halfedgeFace[he], positions) / 3;
+    }
+    vertexDualAreas[i] = dualArea;
+  }
+  meanEdgeLength = 0;
+  for (std::size_t e = 0; e < cn.nEdges; ++e)
+    meanEdgeLength += cn.edgeLength(e, positions);
+  meanEdgeLength /= cn.nEdges;
+
+  // M + t L and L + epsilon M share the pattern of L
+  laplacian.update(cn, edgeCotanWeights, nThreads);
+  const double shortTime = tCoef * meanEdgeLength * meanEdgeLength;
+  Eigen::SparseMatrix<double> heatOperator = laplacian.matrix;
+  Eigen::SparseMatrix<double> poissonOperator = laplacian.matrix;
+  heatOperator *= shortTime;
+  for (std::size_t i = 0; i < cn.nVertices; ++i) {
+    heatOperator.valuePtr()[laplacian.diagonalNonzeros[i]] +=
+        vertexDualAreas[i];
+    poissonOperator.valuePtr()[laplacian.diagonalNonzeros[i]] +=
+        1e-8 / shortTime * vertexDualAreas[i];
+  }
+  heatSolver.factorize(heatOperator);
+  poissonSolver.factorize(poissonOperator);
+  if (heatSolver.info() != Eigen::Success ||
+      poissonSolver.info() != Eigen::Success)
+    mem3dg_runtime_error("GeodesicSolver: factorization failed!");
+  if (interiorSelection.rows() > 0) {
+    dirichletHeatSolver.factorize(interiorSelection * heatOperator *
+                                  interiorSelection.transpose());
+    if (dirichletHeatSolver.info() != Eigen::Success)
+      mem3dg_runtime_error("GeodesicSolver: factorization failed!");
+  }
+
+  factorizedPositions.resize(cn.nVertices);
+  for (std::size_t i = 0; i < cn.nVertices; ++i)
+    factorizedPositions[i] = positions[i];
+  isFactorized = true;
+  ++nFactorizations;
+}
+
+void GeodesicSolver::computeDistance(
+    const Connectivity &cn, const gcs::VertexData<gc::Vector3> &positions,
+    const Source &source, Eigen::VectorXd &distance, double tolerance,
+    std::size_t nThreads) {
+  if (!isAnalyzed || laplacian.diagonalNonzeros.size() != cn.nVertices)
+    analyze(cn);
+
+  // reuse the factorization within the drift tolerance
+  bool isFactorize = !isFactorized;
+  if (!isFactorize) {
+    double maxDrift = tolerance * meanEdgeLength;
+    for (std::size_t i = 0; i < cn.nVertices && !isFactorize; ++i)
+      isFactorize = gc::norm2(positions[i] - factorizedPositions[i]) >
+                    maxDrift * maxDrift;
+  }
+  if (isFactorize)
+    factorize(cn, positions, nThreads);
+
+  // heat flow from the source, averaged with the flow of zero boundary
+  // values on meshes with boundary
+  Eigen::VectorXd impulse = Eigen::VectorXd::Zero(cn.nVertices);
+  for (const std::pair<std::size_t, double> &vertexWeight : source)
+    impulse[vertexWeight.first] += vertexWeight.second;
+  Eigen::VectorXd heat = heatSolver.solve(impulse);
+  if (interiorSelection.rows() > 0)
+    heat = 0.5 * (heat + interiorSelection.transpose() *
+                             dirichletHeatSolver.solve(interiorSelection *
+                                                       impulse));
+
+  // normalized negative gradient of the heat
+  const std::ptrdiff_t nFaces = cn.nFaces, nVertices = cn.nVertices;
+  faceFields.resize(cn.nFaces);
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t f = 0; f < nFaces; ++f) {
+    gc::Vector3 normal = cn.faceNormal(f, positions);
+    gc::Vector3 gradient{0, 0, 0};
+    std::size_t he = cn.faceHalfedge[f];
+    for (int n = 0; n < 3; ++n, he = cn.halfedgeNext[he]) {
+      gradient += heat[cn.halfedgeTip[cn.halfedgeNext[he]]] *
+                  gc::cross(normal, cn.halfedgeVector(he, positions));
+    }
+    double norm = gc::norm(gradient);
+    faceFields[f] = (norm != 0) ? -gradient / norm : gc::Vector3{0, 0, 0};
+  }
+
+  // integrated divergence, gathered by the vertices
+  Eigen::VectorXd divergence(cn.nVertices);
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+    double sum = 0;
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k) {
+      std::size_t he = cn.outgoingHalfedges[k];
+      gc::Vector3 edgeVector = cn.halfedgeVector(he, positions);
+      for (std::size_t l : {he, cn.halfedgeTwin[he]}) {
+        if (cn.isInterior(l))
+          sum += halfedgeCotanWeight(cn, l, positions) *
+                 gc::dot(edgeVector, faceFields[cn.halfedgeFace[l]]);
+      }
+    }
+    divergence[i] = sum;
+  }
+
+  // L phi = -div X, shifted to zero at the source
+  distance = poissonSolver.solve(-divergence);
+  markedDistance = nullptr;
+  double shift = 0;
+  for (const std::pair<std::size_t, double> &vertexWeight : source)
+    shift += vertexWeight.second * distance[vertexWeight.first];
+  distance.array() -= shift;
+}
+
+std::size_t GeodesicSolver::computeBoundedDistance(
+    const Connectivity &cn, const gcs::VertexData<gc::Vector3> &positions,
+    const Source &source, double radius, Eigen::VectorXd &distance) {
+  // the buffers are kept between marches, which leave all but the touched
+  // vertices at the radius
+  if (markedDistance == distance.data() && markedRadius == radius &&
+      static_cast<std::size_t>(distance.size()) == cn.nVertices &&
+      isAccepted.size() == cn.nVertices) {
+    for (std::size_t i : touchedVertices) {
+      distance[i] = radius;
+      isAccepted[i] = false;
+    }
+  } else {
+    distance.setConstant(cn.nVertices, radius);
+    isAccepted.assign(cn.nVertices, false);
+  }
+  touchedVertices.clear();
+  trials.clear();
+  // only vertices within the radius enter the heap, hence the marching
+  // terminates at the radius
+  auto push = [&](std::size_t i, double d) {
+    if (d < distance[i]) {
+      if (distance[i] == radius)
+        touchedVertices.push_back(i);
+      distance[i] = d;
+      trials.emplace_back(d, i);
+      std::push_heap(trials.begin(), trials.end(), std::greater<>());
+    }
+  };
+
+  // the vertices of the source face (or edge) are in its plane
+  gc::Vector3 point{0, 0, 0};
+  for (const std::pair<std::size_t, double> &vertexWeight : source)
+    point += vertexWeight.second * positions[vertexWeight.first];
+  for (const std::pair<std::size_t, double> &vertexWeight : source)
+    push(vertexWeight.first, gc::norm(positions[vertexWeight.first] - point));
+
+  std::size_t nAccepted = 0;
+  while (!trials.empty()) {
+    std::pop_heap(trials.begin(), trials.end(), std::greater<>());
+    std::size_t i = trials.back().second;
+    double d = trials.back().first;
+    trials.pop_back();
+    if (isAccepted[i] || d > distance[i])
+      continue;
+    isAccepted[i] = true;
+    ++nAccepted;
+
+    // update the other two vertices of the adjacent faces
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k) {
+      std::size_t he = cn.outgoingHalfedges[k];
+      if (!cn.isInterior(he))
+        continue;
+      std::size_t j = cn.halfedgeTip[he];
+      std::size_t l = cn.halfedgeTip[cn.halfedgeNext[he]];
+      for (std::size_t n = 0; n < 2; ++n, std::swap(j, l)) {
+        if (isAccepted[j])
+          continue;
+        push(j, isAccepted[l]
+                    ? triangleUpdate(positions[i], positions[l], positions[j],
+                                     d, distance[l])
+                    : d + gc::norm(positions[j] - positions[i]));
+      }
+    }
+  }
+  markedDistance = distance.data();
+  markedRadius = radius;
+  return nAccepted;
+}
+
+} // namespace solver
+} // namespace mem3dg
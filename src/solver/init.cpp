@@ -20,7 +20,10 @@
 #include "mem3dg/constants.h"
 #include "mem3dg/meshops.h"
 #include "mem3dg/solver/mutable_trajfile.h"
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <numeric>
 #include <stdexcept>
 #include <vector>
 #ifdef MEM3DG_WITH_NETCDF
@@ -261,15 +264,26 @@ void System::checkConfiguration() {
         "specifying x-y coordinate on closed surface may"
         "lead to ambiguity! Please check by visualizing it first!");
   }
-  if (parameters.selfAvoidance.mu != 0) {
+  if (parameters.selfAvoidance.mu != 0 && parameters.selfAvoidance.cutoff > 0) {
+    findSelfAvoidancePairs();
+    for (const SpatialHash::Pair &ij : selfAvoidancePairs) {
+      if (gc::norm(vpg->inputVertexPositions[ij.second] -
+                   vpg->inputVertexPositions[ij.first]) <
+          parameters.selfAvoidance.d)
+        mem3dg_runtime_error(
+            "Input mesh violates the self avoidance constraint!");
+    }
+  } else if (parameters.selfAvoidance.mu != 0) {
+    updateSelfAvoidanceExclusions();
     for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
       gc::Vertex vi{mesh->vertex(i)};
-      gc::VertexData<bool> neighborList(*mesh, false);
-      meshProcessor.meshMutator.markVertices(neighborList, vi,
-                                             parameters.selfAvoidance.n);
+      std::size_t k = selfAvoidanceExclusionOffsets[i];
       for (std::size_t j = i + 1; j < mesh->nVertices(); ++j) {
-        if (neighborList[j])
+        if (k < selfAvoidanceExclusionOffsets[i + 1] &&
+            selfAvoidanceExclusions[k] == j) {
+          ++k;
           continue;
+        }
         gc::Vertex vj{mesh->vertex(j)};
         gc::Vector3 r =
             vpg->inputVertexPositions[vj] - vpg->inputVertexPositions[vi];
@@ -309,6 +323,9 @@ void System::initConstants() {
   pcg_extras::seed_seq_from<std::random_device> seed_source;
   rng = pcg32(seed_source);
 
+  // Select the force kernel of the active energy terms
+  updateActiveForceTerms();
+
   // // Initialize V-E distribution matrix for line tension calculation
   // if (P.dirichlet.eta != 0) {
   //   D = localVpg->d0.transpose().cwiseAbs() / 2;
@@ -324,8 +341,7 @@ void System::initConstants() {
   findThePoint(*vpg, geodesicDistanceFromPtInd, 1e18);
 
   // Initialize const geodesic distance
-  gcs::HeatMethodDistanceSolver heatSolver(*vpg);
-  geodesicDistanceFromPtInd = heatSolver.computeDistance(thePoint);
+  updateGeodesicDistance();
 
   // Initialize the constant mask based on distance from the point specified
   if (parameters.variation.radius != -1) {
@@ -403,9 +419,13 @@ void System::initConstants() {
 }
 
 void System::updateConfigurations(bool isUpdateGeodesics) {
+  isMechanicalForcesCurrent = false;
+
+  // pick up changes of the force parameters since the last update
+  updateActiveForceTerms();
 
   // refresh cached quantities after regularization
-  vpg->refreshQuantities();
+  refreshGeometry();
 
   // recompute floating "the vertex"
   if (parameters.point.isFloatVertex && isUpdateGeodesics) {
@@ -416,8 +436,7 @@ void System::updateConfigurations(bool isUpdateGeodesics) {
 
   // update geodesic distance
   if (isUpdateGeodesics) {
-    gcs::HeatMethodDistanceSolver heatSolver(*vpg);
-    geodesicDistanceFromPtInd = heatSolver.computeDistance(thePoint);
+    updateGeodesicDistance(true);
   }
 
   // initialize/update external force
@@ -480,33 +499,7 @@ void System::updateConfigurations(bool isUpdateGeodesics) {
     mem3dg_runtime_error("updateVertexPosition: P.relation is invalid option!");
   }
 
-  /// initialize/update enclosed volume
-  volume = getMeshVolume(*mesh, *vpg, true) + parameters.osmotic.V_res;
-
-  // update global osmotic pressure
-  if (parameters.osmotic.isPreferredVolume) {
-    forces.osmoticPressure =
-        -(parameters.osmotic.Kv * (volume - parameters.osmotic.Vt) /
-              parameters.osmotic.Vt / parameters.osmotic.Vt +
-          parameters.osmotic.lambdaV);
-  } else if (parameters.osmotic.isConstantOsmoticPressure) {
-    forces.osmoticPressure = parameters.osmotic.Kv;
-  } else {
-    forces.osmoticPressure =
-        mem3dg::constants::i * mem3dg::constants::R * parameters.temperature *
-        (parameters.osmotic.n / volume - parameters.osmotic.cam);
-  }
-
-  // initialize/update total surface area
-  surfaceArea = vpg->faceAreas.raw().sum() + parameters.tension.A_res;
-
-  // update global surface tension
-  forces.surfaceTension = parameters.tension.isConstantSurfaceTension
-                              ? parameters.tension.Ksg
-                              : parameters.tension.Ksg *
-                                        (surfaceArea - parameters.tension.At) /
-                                        parameters.tension.At +
-                                    parameters.tension.lambdaSG;
+  updateGlobalQuantities();
 
   // initialize/update line tension (on dual edge)
   if (parameters.dirichlet.eta != 0 && false) {
@@ -524,6 +517,449 @@ void System::updateConfigurations(bool isUpdateGeodesics) {
   }
 }
 
+void System::updateGlobalQuantities() {
+  /// initialize/update enclosed volume, unless just computed by the fused
+  /// geometry sweep
+  if (!isGlobalGeometryCurrent)
+    volume = getMeshVolume(*mesh, *vpg, true) + parameters.osmotic.V_res;
+
+  // update global osmotic pressure
+  forces.osmoticPressure = getOsmoticPressure(volume);
+
+  // initialize/update total surface area
+  if (!isGlobalGeometryCurrent)
+    surfaceArea = vpg->faceAreas.raw().sum() + parameters.tension.A_res;
+  isGlobalGeometryCurrent = false;
+
+  // update global surface tension
+  forces.surfaceTension = getSurfaceTension(surfaceArea);
+}
+
+double System::getOsmoticPressure(double enclosedVolume) const {
+  if (parameters.osmotic.isPreferredVolume) {
+    return -(parameters.osmotic.Kv * (enclosedVolume - parameters.osmotic.Vt) /
+                 parameters.osmotic.Vt / parameters.osmotic.Vt +
+             parameters.osmotic.lambdaV);
+  } else if (parameters.osmotic.isConstantOsmoticPressure) {
+    return parameters.osmotic.Kv;
+  } else {
+    return mem3dg::constants::i * mem3dg::constants::R *
+           parameters.temperature *
+           (parameters.osmotic.n / enclosedVolume - parameters.osmotic.cam);
+  }
+}
+
+double System::getSurfaceTension(double area) const {
+  return parameters.tension.isConstantSurfaceTension
+             ? parameters.tension.Ksg
+             : parameters.tension.Ksg * (area - parameters.tension.At) /
+                       parameters.tension.At +
+                   parameters.tension.lambdaSG;
+}
+
+void System::refreshGeometry(bool isRefreshOperators) {
+  auto timed = [this](const std::string &name, auto &&refresh) {
+    auto start = std::chrono::steady_clock::now();
+    refresh();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    refreshTimings[name] += elapsed.count();
+  };
+
+  isGlobalGeometryCurrent = false;
+  if (!isSelectiveRefresh || isRefreshOperators) {
+    timed("all", [this] { vpg->refreshQuantities(); });
+    isGeometryOperatorsCurrent = true;
+    if (parameters.dirichlet.eta != 0)
+      timed("cotanLaplacian", [this] { updateCotanLaplacian(); });
+    return;
+  }
+  isGeometryOperatorsCurrent = false;
+  timed("fusedSweep", [this] { computeGeometrySweep(); });
+
+  // the only consumer of the cotan Laplacian is the Dirichlet energy
+  if (parameters.dirichlet.eta != 0)
+    timed("cotanLaplacian", [this] { updateCotanLaplacian(); });
+}
+
+void System::computeGeometrySweep() {
+  if (!connectivity.isCurrent(*mesh))
+    connectivity.build(*mesh);
+  const Connectivity &cn = connectivity;
+  const gcs::VertexData<gc::Vector3> &pos = vpg->inputVertexPositions;
+  const std::ptrdiff_t nEdges = cn.nEdges, nVertices = cn.nVertices;
+  // faces per block of the area and volume sums, smaller than
+  // REDUCTION_BLOCK_SIZE to balance the face phase on small meshes
+  const std::size_t blockSize = 256;
+  const std::ptrdiff_t nBlocks = (cn.nFaces + blockSize - 1) / blockSize;
+  std::vector<double> blockAreas(nBlocks), blockVolumes(nBlocks);
+  // start of the face, edge and vertex phases and end of the sweep, stamped
+  // by the master thread after the barrier of each phase
+  std::chrono::steady_clock::time_point stamps[4];
+
+  // vertex quantities read edge quantities, which read face quantities,
+  // hence three phases in one parallel region
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel num_threads(getNumThreads(nThreads))
+#endif
+  {
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp master
+#endif
+    stamps[0] = std::chrono::steady_clock::now();
+
+    // faces: area, normal, corner angles, cotan weights and volume, summed
+    // by fixed blocks for reproducibility
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (std::ptrdiff_t b = 0; b < nBlocks; ++b) {
+      const std::size_t end =
+          std::min<std::size_t>(cn.nFaces, (b + 1) * blockSize);
+      double blockArea = 0, blockVolume = 0;
+      for (std::size_t f = b * blockSize; f < end; ++f) {
+        std::size_t he[3];
+        he[0] = cn.faceHalfedge[f];
+        he[1] = cn.halfedgeNext[he[0]];
+        he[2] = cn.halfedgeNext[he[1]];
+        gc::Vector3 p[3] = {pos[cn.halfedgeTail[he[0]]],
+                            pos[cn.halfedgeTail[he[1]]],
+                            pos[cn.halfedgeTail[he[2]]]};
+        gc::Vector3 areaVector = gc::cross(p[1] - p[0], p[2] - p[0]);
+        double doubleArea = gc::norm(areaVector);
+        vpg->faceAreas[f] = 0.5 * doubleArea;
+        vpg->faceNormals[f] = areaVector / doubleArea;
+        blockArea += 0.5 * doubleArea;
+        blockVolume += signedVolumeFromFace(p[0], p[1], p[2]);
+        for (int n = 0; n < 3; ++n) {
+          const gc::Vector3 &pTail = p[n], &pTip = p[(n + 1) % 3],
+                            &pOpposite = p[(n + 2) % 3];
+          // the corner of the halfedge is at its tail
+          double cosine = gc::dot(gc::unit(pTip - pTail),
+                                  gc::unit(pOpposite - pTail));
+          vpg->cornerAngles[mesh->halfedge(he[n]).corner()] =
+              std::acos(std::max(-1.0, std::min(1.0, cosine)));
+          gc::Vector3 vecR = pTail - pOpposite, vecL = pTip - pOpposite;
+          vpg->halfedgeCotanWeights[he[n]] =
+              0.5 * gc::dot(vecR, vecL) / gc::norm(gc::cross(vecR, vecL));
+        }
+      }
+      blockAreas[b] = blockArea;
+      blockVolumes[b] = blockVolume;
+    }
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp master
+#endif
+    stamps[1] = std::chrono::steady_clock::now();
+
+    // edges: length, cotan weight and dihedral angle
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (std::ptrdiff_t e = 0; e < nEdges; ++e) {
+      std::size_t he = cn.edgeHalfedge[e], he_twin = cn.halfedgeTwin[he];
+      gc::Vector3 edgeVector = cn.halfedgeVector(he, pos);
+      vpg->edgeLengths[e] = gc::norm(edgeVector);
+      double weight = 0;
+      for (std::size_t k : {he, he_twin}) {
+        if (!cn.isInterior(k))
+          vpg->halfedgeCotanWeights[k] = 0;
+        weight += vpg->halfedgeCotanWeights[k];
+      }
+      vpg->edgeCotanWeights[e] = weight;
+      if (cn.isInterior(he) && cn.isInterior(he_twin)) {
+        const gc::Vector3 &N1 = vpg->faceNormals[cn.halfedgeFace[he]];
+        const gc::Vector3 &N2 = vpg->faceNormals[cn.halfedgeFace[he_twin]];
+        vpg->edgeDihedralAngles[e] =
+            std::atan2(gc::dot(gc::unit(edgeVector), gc::cross(N1, N2)),
+                       gc::dot(N1, N2));
+      } else {
+        vpg->edgeDihedralAngles[e] = 0;
+      }
+    }
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp master
+#endif
+    stamps[2] = std::chrono::steady_clock::now();
+
+    // vertices: dual area, mean and Gaussian curvature and normal
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+      double dualArea = 0, meanCurvature = 0;
+      double gaussianCurvature =
+          cn.isBoundaryVertex(i) ? constants::PI : 2 * constants::PI;
+      gc::Vector3 normal{0, 0, 0};
+      for (std::size_t k = cn.outgoingOffsets[i];
+           k < cn.outgoingOffsets[i + 1]; ++k) {
+        std::size_t he = cn.outgoingHalfedges[k];
+        std::size_t e = cn.halfedgeEdge[he];
+        meanCurvature += vpg->edgeDihedralAngles[e] * vpg->edgeLengths[e];
+        if (cn.isInterior(he)) {
+          std::size_t f = cn.halfedgeFace[he];
+          double angle = vpg->cornerAngles[mesh->halfedge(he).corner()];
+          dualArea += vpg->faceAreas[f] / 3;
+          gaussianCurvature -= angle;
+          normal += angle * vpg->faceNormals[f];
+        }
+      }
+      vpg->vertexDualAreas[i] = dualArea;
+      vpg->vertexMeanCurvatures[i] = meanCurvature / 4;
+      vpg->vertexGaussianCurvatures[i] = gaussianCurvature;
+      vpg->vertexNormals[i] = gc::unit(normal);
+    }
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp master
+#endif
+    stamps[3] = std::chrono::steady_clock::now();
+  }
+  const char *phases[3] = {"fusedSweep/faces", "fusedSweep/edges",
+                           "fusedSweep/vertices"};
+  for (int n = 0; n < 3; ++n) {
+    std::chrono::duration<double> elapsed = stamps[n + 1] - stamps[n];
+    refreshTimings[phases[n]] += elapsed.count();
+  }
+
+  // pairwise combination of the block sums
+  for (std::size_t stride = 1; stride < blockAreas.size(); stride *= 2) {
+    for (std::size_t b = 0; b + stride < blockAreas.size(); b += 2 * stride) {
+      blockAreas[b] += blockAreas[b + stride];
+      blockVolumes[b] += blockVolumes[b + stride];
+    }
+  }
+  surfaceArea = (blockAreas.empty() ? 0 : blockAreas[0]) +
+                parameters.tension.A_res;
+  volume = (blockVolumes.empty() ? 0 : blockVolumes[0]) +
+           (isOpenMesh ? getHoleFillVolume(*mesh, *vpg) : 0) +
+           parameters.osmotic.V_res;
+  isGlobalGeometryCurrent = true;
+}
+
+void System::updateCotanLaplacian() {
+  if (!connectivity.isCurrent(*mesh))
+    connectivity.build(*mesh);
+  if (!isCotanLaplacianPatternCurrent ||
+      cotanLaplacian.diagonalNonzeros.size() != connectivity.nVertices) {
+    cotanLaplacian.build(connectivity);
+    isCotanLaplacianPatternCurrent = true;
+  }
+  cotanLaplacian.update(connectivity, vpg->edgeCotanWeights.raw(), nThreads);
+}
+
+void System::updateGeodesicDistance(bool isLocal) {
+  if (!connectivity.isCurrent(*mesh))
+    connectivity.build(*mesh);
+
+  // vertex weights of the surface point
+  GeodesicSolver::Source source;
+  switch (thePoint.type) {
+  case gcs::SurfacePointType::Vertex: {
+    source.emplace_back(thePoint.vertex.getIndex(), 1);
+    break;
+  }
+  case gcs::SurfacePointType::Edge: {
+    gcs::Halfedge he = thePoint.edge.halfedge();
+    source.emplace_back(he.tailVertex().getIndex(), 1 - thePoint.tEdge);
+    source.emplace_back(he.tipVertex().getIndex(), thePoint.tEdge);
+    break;
+  }
+  case gcs::SurfacePointType::Face: {
+    gcs::Halfedge he = thePoint.face.halfedge();
+    for (int n = 0; n < 3; ++n, he = he.next())
+      source.emplace_back(he.tailVertex().getIndex(), thePoint.faceCoords[n]);
+    break;
+  }
+  }
+
+  if (isLocal && parameters.point.geodesicRadius != 0) {
+    geodesicSolver.computeBoundedDistance(
+        connectivity, vpg->inputVertexPositions, source,
+        parameters.point.geodesicRadius, geodesicDistanceFromPtInd.raw());
+    return;
+  }
+  if (!isGeodesicSolverCurrent) {
+    geodesicSolver.analyze(connectivity);
+    isGeodesicSolverCurrent = true;
+  }
+  geodesicSolver.computeDistance(connectivity, vpg->inputVertexPositions,
+                                 source, geodesicDistanceFromPtInd.raw(),
+                                 parameters.point.geodesicTolerance, nThreads);
+}
+
+bool System::updateMutatedConfigurations() {
+  // shifted vertices are not marked, and the cotan Laplacian of the chemical
+  // potential can not be updated locally
+  isMutatedForcesLocal = false;
+  if (meshProcessor.meshMutator.shiftVertex ||
+      (parameters.variation.isProteinVariation &&
+       parameters.dirichlet.eta != 0)) {
+    updateConfigurations(false);
+    return false;
+  }
+  // the volume and surface area are summed again over the whole mesh, and the
+  // DEC operators are left to the next full refresh
+  isGlobalGeometryCurrent = false;
+  isGeometryOperatorsCurrent = false;
+  updateActiveForceTerms();
+  if (!connectivity.isCurrent(*mesh))
+    connectivity.build(*mesh);
+  const Connectivity &cn = connectivity;
+
+  // mutated vertices, their 1-ring and 2-ring
+  std::vector<std::uint8_t> vertexMarker(cn.nVertices, false);
+  std::vector<std::size_t> mutatedVertices;
+  for (std::size_t i = 0; i < cn.nVertices; ++i) {
+    if (mutationMarker[i]) {
+      vertexMarker[i] = true;
+      mutatedVertices.push_back(i);
+    }
+  }
+  std::vector<std::size_t> ringVertices =
+      cn.expandRing(mutatedVertices, vertexMarker);
+  std::vector<std::size_t> forceVertices =
+      cn.expandRing(ringVertices, vertexMarker);
+
+  // faces adjacent to the mutated vertices and their edges
+  std::vector<std::uint8_t> faceMarker(cn.nFaces, false);
+  std::vector<std::uint8_t> edgeMarker(cn.nEdges, false);
+  std::vector<std::size_t> faces, edges;
+  for (std::size_t i : mutatedVertices) {
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k) {
+      std::size_t f = cn.halfedgeFace[cn.outgoingHalfedges[k]];
+      if (f == Connectivity::INVALID_IND || faceMarker[f])
+        continue;
+      faceMarker[f] = true;
+      faces.push_back(f);
+      std::size_t he = cn.faceHalfedge[f];
+      for (int n = 0; n < 3; ++n, he = cn.halfedgeNext[he]) {
+        std::size_t e = cn.halfedgeEdge[he];
+        if (!edgeMarker[e]) {
+          edgeMarker[e] = true;
+          edges.push_back(e);
+        }
+      }
+    }
+  }
+
+  // refresh the cached geometry with immediate calculation
+  for (std::size_t f : faces) {
+    gcs::Face face{mesh->face(f)};
+    vpg->faceAreas[f] = vpg->faceArea(face);
+    vpg->faceNormals[f] = vpg->faceNormal(face);
+    for (gcs::Corner c : face.adjacentCorners()) {
+      vpg->cornerAngles[c] = vpg->cornerAngle(c);
+    }
+  }
+  std::vector<std::size_t> halfedges;
+  halfedges.reserve(2 * edges.size());
+  for (std::size_t e : edges) {
+    gcs::Edge edge{mesh->edge(e)};
+    vpg->edgeLengths[e] = vpg->edgeLength(edge);
+    vpg->edgeDihedralAngles[e] = vpg->edgeDihedralAngle(edge);
+    vpg->edgeCotanWeights[e] = vpg->edgeCotanWeight(edge);
+    std::size_t he = cn.edgeHalfedge[e];
+    for (std::size_t k : {he, cn.halfedgeTwin[he]}) {
+      vpg->halfedgeCotanWeights[k] =
+          vpg->halfedgeCotanWeight(gcs::Halfedge{mesh->halfedge(k)});
+      halfedges.push_back(k);
+    }
+  }
+  for (std::size_t i : ringVertices) {
+    gcs::Vertex v{mesh->vertex(i)};
+    vpg->vertexDualAreas[i] = vpg->vertexDualArea(v);
+    vpg->vertexMeanCurvatures[i] = vpg->vertexMeanCurvature(v);
+    // angle defect and angle weighted normal
+    double gaussianCurvature =
+        cn.isBoundaryVertex(i) ? constants::PI : 2 * constants::PI;
+    gc::Vector3 normal{0, 0, 0};
+    for (gcs::Corner c : v.adjacentCorners()) {
+      gaussianCurvature -= vpg->cornerAngles[c];
+      normal += vpg->cornerAngles[c] * vpg->faceNormals[c.face()];
+    }
+    vpg->vertexGaussianCurvatures[i] = gaussianCurvature;
+    vpg->vertexNormals[i] = gc::unit(normal);
+  }
+
+  // compute face gradient of protein density
+  if (parameters.dirichlet.eta != 0) {
+    if ((proteinDensity.raw().array() == proteinDensity.raw()[0]).all()) {
+      proteinDensityGradient.fill({0, 0, 0});
+    } else {
+      for (std::size_t f : faces) {
+        gcs::Face face{mesh->face(f)};
+        gc::Vector3 normal = vpg->faceNormals[f];
+        gc::Vector3 gradientVec{0, 0, 0};
+        for (gcs::Halfedge he : face.adjacentHalfedges()) {
+          gradientVec += proteinDensity[he.next().tipVertex()] *
+                         gc::cross(normal, vecFromHalfedge(he, *vpg));
+        }
+        proteinDensityGradient[f] = gradientVec / 2 / vpg->faceAreas[f];
+      }
+    }
+  }
+
+  // update protein density dependent quantities of the mutated vertices
+  for (std::size_t i : mutatedVertices) {
+    double phi = proteinDensity[i];
+    if (parameters.bending.relation == "linear") {
+      H0[i] = phi * parameters.bending.H0c;
+      Kb[i] = parameters.bending.Kb + parameters.bending.Kbc * phi;
+      Kd[i] = parameters.bending.Kd + parameters.bending.Kdc * phi;
+    } else if (parameters.bending.relation == "hill") {
+      double phiSq = phi * phi;
+      H0[i] = parameters.bending.H0c * phiSq / (1 + phiSq);
+      Kb[i] = parameters.bending.Kb +
+              parameters.bending.Kbc * phiSq / (1 + phiSq);
+      Kd[i] = parameters.bending.Kd +
+              parameters.bending.Kdc * phiSq / (1 + phiSq);
+    } else {
+      mem3dg_runtime_error(
+          "updateMutatedConfigurations: P.relation is invalid option!");
+    }
+  }
+
+  double surfaceTension = forces.surfaceTension;
+  double osmoticPressure = forces.osmoticPressure;
+  updateGlobalQuantities();
+
+  // the mechanical forces away from the mutation only depend on the global
+  // tension and pressure, through the cached area and volume gradients. In
+  // lean mode the cached sum includes the external forces, hence all
+  // vertices are updated
+  computeVariationalVectors(ringVertices, halfedges, activeForceTerms);
+  if (parameters.variation.isShapeVariation) {
+    if (isDecomposeForces) {
+      if (forces.surfaceTension != surfaceTension ||
+          forces.osmoticPressure != osmoticPressure) {
+        const std::ptrdiff_t nVertices = cn.nVertices;
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+        for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+          forces.capillaryForceVec[i] =
+              -forces.surfaceTension * forces.areaGradientVec[i];
+          forces.osmoticForceVec[i] =
+              forces.osmoticPressure * forces.volumeGradientVec[i];
+          forces.capillaryForce[i] =
+              forces.ontoNormal(forces.capillaryForceVec[i], i);
+          forces.osmoticForce[i] =
+              forces.ontoNormal(forces.osmoticForceVec[i], i);
+        }
+      }
+      computeMechanicalForces(forceVertices);
+      isMutatedForcesLocal = true;
+    } else {
+      std::vector<std::size_t> vertices(cn.nVertices);
+      std::iota(vertices.begin(), vertices.end(), 0);
+      computeMechanicalForces(vertices);
+    }
+    isMechanicalForcesCurrent = true;
+  }
+  return true;
+}
+
 double System::inferTargetSurfaceArea() {
   double targetArea;
   if (isOpenMesh) {
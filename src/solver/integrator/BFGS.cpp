@@ -121,6 +121,15 @@ void BFGS::checkParameters() {
     if (rho >= 1 || rho <= 0 || c1 >= 1 || c1 <= 0) {
       mem3dg_runtime_error("To backtrack, 0<rho<1 and 0<c1<1!");
     }
+    if (lineSearch != "backtrack" && lineSearch != "moreThuente") {
+      mem3dg_runtime_error("lineSearch is either backtrack or moreThuente!");
+    }
+    if (lineSearch == "moreThuente" && (c2 >= 1 || c2 <= c1)) {
+      mem3dg_runtime_error("For More-Thuente line search, c1<c2<1!");
+    }
+    if (stepGrowth < 1) {
+      mem3dg_runtime_error("stepGrowth >= 1 is required!");
+    }
   }
   if (system.parameters.external.Kf != 0) {
     mem3dg_runtime_error(
@@ -132,8 +141,8 @@ void BFGS::status() {
   auto physicalForceVec = toMatrix(system.forces.mechanicalForceVec);
   auto physicalForce = toMatrix(system.forces.mechanicalForce);
 
-  // compute summerized forces
-  system.computePhysicalForcing(timeStep);
+  // compute summerized forces and the free energy of the system
+  system.computePhysicalForcingAndEnergy(timeStep);
 
   // update
   if (system.time != initialTime || ifRestart) {
@@ -195,9 +204,6 @@ void BFGS::status() {
     SUCCESS = false;
   }
 
-  // compute the free energy of the system
-  system.computeTotalEnergy();
-
   // backtracking for error
   finitenessErrorBacktrace();
 }
@@ -229,24 +235,24 @@ void BFGS::march() {
       updateAdaptiveCharacteristicStep();
     }
 
-    // time stepping on vertex position
-    timeStep =
-        backtrack(f_velocity_e, toMatrix(system.proteinVelocity), rho, c1);
-    system.vpg->inputVertexPositions += system.velocity * timeStep;
-    system.proteinDensity += system.proteinVelocity * timeStep;
-    system.time += timeStep;
+    // time stepping on vertex position, the line search takes the step
+    if (lineSearch == "moreThuente") {
+      timeStep = wolfeLineSearch(c1, c2);
+    } else if (lineSearch == "backtrack") {
+      timeStep = backtrack(rho, c1);
+    } else {
+      mem3dg_runtime_error("lineSearch is either backtrack or moreThuente!");
+    }
     s = timeStep * flatten(f_velocity_e);
     s_protein = timeStep * toMatrix(system.proteinVelocity);
 
-    // regularization
+    // regularization and recompute cached values
     if (system.meshProcessor.isMeshRegularize) {
       system.computeRegularizationForce();
       system.vpg->inputVertexPositions.raw() +=
           system.forces.regularizationForce.raw();
+      system.updateConfigurations(false);
     }
-
-    // recompute cached values
-    system.updateConfigurations(false);
   }
 }
 } // namespace integrator
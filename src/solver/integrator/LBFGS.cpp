@@ -0,0 +1,287 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#include <Eigen/Core>
+#include <iostream>
+#include <limits>
+#include <math.h>
+#include <vector>
+
+#include <geometrycentral/surface/halfedge_mesh.h>
+#include <geometrycentral/surface/meshio.h>
+#include <geometrycentral/surface/vertex_position_geometry.h>
+#include <geometrycentral/utilities/eigen_interop_helpers.h>
+#include <geometrycentral/utilities/vector3.h>
+#include <stdexcept>
+
+#include "mem3dg/meshops.h"
+#include "mem3dg/solver/integrator/integrator.h"
+#include "mem3dg/solver/integrator/lbfgs.h"
+#include "mem3dg/solver/system.h"
+
+namespace mem3dg {
+namespace solver {
+namespace integrator {
+namespace gc = ::geometrycentral;
+
+bool LBFGS::integrate() {
+
+  signal(SIGINT, signalHandler);
+
+#ifdef __linux__
+  // start the timer
+  struct timeval start;
+  gettimeofday(&start, NULL);
+#endif
+
+  // initialize netcdf traj file
+#ifdef MEM3DG_WITH_NETCDF
+  if (verbosity > 0) {
+    // createNetcdfFile();
+    createMutableNetcdfFile();
+    // print to console
+    std::cout << "Initialized integrator and the output trajactory is "
+              << outputDirectory + "/" + trajFileName << std::endl;
+  }
+#endif
+
+  // time integration loop
+  for (;;) {
+
+    // Evaluate and threhold status data
+    status();
+
+    // Save files every tSave period and print some info
+    if (system.time - lastSave >= savePeriod || system.time == initialTime ||
+        EXIT) {
+      lastSave = system.time;
+      saveData();
+    }
+
+    // break loop if EXIT flag is on
+    if (EXIT) {
+      break;
+    }
+
+    // step forward
+    march();
+  }
+
+  // return if optimization is sucessful
+  if (!SUCCESS) {
+    if (tolerance == 0) {
+      markFileName("_most");
+    } else {
+      markFileName("_failed");
+    }
+  }
+
+  // stop the timer and report time spent
+#ifdef __linux__
+  double duration = getDuration(start);
+  if (verbosity > 0) {
+    std::cout << "\nTotal integration time: " << duration << " seconds"
+              << std::endl;
+  }
+#endif
+
+  return SUCCESS;
+}
+
+void LBFGS::checkParameters() {
+  if (system.parameters.dpd.gamma != 0) {
+    mem3dg_runtime_error("DPD has to be turned off for L-BFGS integration!");
+  }
+  if (system.parameters.proteinMobility != 1 &&
+      system.parameters.proteinMobility != 0) {
+    mem3dg_runtime_error("Protein mobility constant should "
+                         "be set to 1 for optimization!");
+  }
+  if (system.parameters.damping != 0) {
+    mem3dg_runtime_error("Damping to be 0 for L-BFGS integration!");
+  }
+  if (rho >= 1 || rho <= 0 || c1 >= 1 || c1 <= 0) {
+    mem3dg_runtime_error("To backtrack, 0<rho<1 and 0<c1<1!");
+  }
+  if (lineSearch != "backtrack" && lineSearch != "moreThuente") {
+    mem3dg_runtime_error("lineSearch is either backtrack or moreThuente!");
+  }
+  if (lineSearch == "moreThuente" && (c2 >= 1 || c2 <= c1)) {
+    mem3dg_runtime_error("For More-Thuente line search, c1<c2<1!");
+  }
+  if (stepGrowth < 1) {
+    mem3dg_runtime_error("stepGrowth >= 1 is required!");
+  }
+  if (historyLength < 1) {
+    mem3dg_runtime_error("historyLength > 0!");
+  }
+  if (system.parameters.external.Kf != 0) {
+    mem3dg_runtime_error(
+        "External force can not be applied using energy optimization")
+  }
+}
+
+void LBFGS::clearHistory() {
+  s.clear();
+  y.clear();
+  s_protein.clear();
+  y_protein.clear();
+  isStepPending = false;
+}
+
+void LBFGS::pushHistory(std::deque<EigenVectorX1d> &steps,
+                        std::deque<EigenVectorX1d> &differences,
+                        const EigenVectorX1d &step,
+                        const EigenVectorX1d &difference) {
+  // skip the pair without positive curvature, which would make the inverse
+  // Hessian approximation indefinite
+  if (step.dot(difference) <=
+      std::numeric_limits<double>::epsilon() * difference.squaredNorm())
+    return;
+  steps.push_back(step);
+  differences.push_back(difference);
+  while (steps.size() > historyLength) {
+    steps.pop_front();
+    differences.pop_front();
+  }
+}
+
+void LBFGS::applyInverseHessian(const std::deque<EigenVectorX1d> &steps,
+                                const std::deque<EigenVectorX1d> &differences,
+                                EigenVectorX1d &vector) const {
+  const std::size_t m = steps.size();
+  std::vector<double> alpha(m), inverseCurvature(m);
+  for (std::size_t i = m; i-- > 0;) {
+    inverseCurvature[i] = 1 / steps[i].dot(differences[i]);
+    alpha[i] = inverseCurvature[i] * steps[i].dot(vector);
+    vector -= alpha[i] * differences[i];
+  }
+  for (std::size_t i = 0; i < m; ++i) {
+    double beta = inverseCurvature[i] * differences[i].dot(vector);
+    vector += (alpha[i] - beta) * steps[i];
+  }
+}
+
+void LBFGS::status() {
+  auto physicalForceVec = toMatrix(system.forces.mechanicalForceVec);
+
+  // compute summerized forces and the free energy of the system
+  system.computePhysicalForcingAndEnergy(timeStep);
+
+  // update the history with the last step
+  if (isStepPending) {
+    if (system.parameters.variation.isShapeVariation)
+      pushHistory(s, y, pastStep,
+                  pastPhysicalForce - flatten(physicalForceVec));
+    if (system.parameters.variation.isProteinVariation)
+      pushHistory(s_protein, y_protein, pastStep_protein,
+                  pastPhysicalForce_protein -
+                      system.forces.chemicalPotential.raw());
+    isStepPending = false;
+  }
+
+  // compute the area contraint error
+  areaDifference =
+      (system.parameters.tension.Ksg != 0)
+          ? abs(system.surfaceArea / system.parameters.tension.At - 1)
+          : 0.0;
+
+  if (system.parameters.osmotic.isPreferredVolume) {
+    // compute volume constraint error
+    volumeDifference =
+        (system.parameters.osmotic.Kv != 0)
+            ? abs(system.volume / system.parameters.osmotic.Vt - 1)
+            : 0.0;
+    // thresholding, exit if fulfilled and iterate if not
+    reducedVolumeThreshold(EXIT, isAugmentedLagrangian, areaDifference,
+                           volumeDifference, ctol, 1.3);
+  } else {
+    // compute pressure constraint error
+    volumeDifference = (!system.mesh->hasBoundary())
+                           ? abs(system.parameters.osmotic.n / system.volume /
+                                     system.parameters.osmotic.cam -
+                                 1.0)
+                           : 1.0;
+    // thresholding, exit if fulfilled and iterate if not
+    pressureConstraintThreshold(EXIT, isAugmentedLagrangian, areaDifference,
+                                ctol, 1.3);
+  }
+
+  // exit if reached time
+  if (system.time > totalTime) {
+    std::cout << "\nReached time." << std::endl;
+    EXIT = true;
+    SUCCESS = false;
+  }
+
+  // backtracking for error
+  finitenessErrorBacktrace();
+}
+
+void LBFGS::march() {
+  if (system.time == lastSave && system.time != initialTime) {
+    // process the mesh with regularization or mutation
+    system.mutateMesh();
+    system.updateConfigurations(true);
+
+    system.time += 1e-10 * characteristicTimeStep;
+    // the history does not apply to the processed mesh
+    clearHistory();
+  } else {
+    // map the raw eigen datatype for computation
+    auto f_velocity_e = toMatrix(system.velocity);
+    auto f_forces_mechanicalForceVec_e =
+        toMatrix(system.forces.mechanicalForceVec);
+
+    // quasi-Newton directions
+    pastPhysicalForce = flatten(f_forces_mechanicalForceVec_e);
+    pastPhysicalForce_protein = system.forces.chemicalPotential.raw();
+    EigenVectorX1d direction = pastPhysicalForce;
+    applyInverseHessian(s, y, direction);
+    f_velocity_e = unflatten<3>(direction);
+    EigenVectorX1d direction_protein =
+        system.parameters.proteinMobility * pastPhysicalForce_protein;
+    applyInverseHessian(s_protein, y_protein, direction_protein);
+    toMatrix(system.proteinVelocity) = direction_protein;
+
+    // adjust time step if adopt adaptive time step based on mesh size and force
+    // magnitude
+    if (isAdaptiveStep) {
+      updateAdaptiveCharacteristicStep();
+    }
+
+    // time stepping on vertex position, the line search takes the step
+    if (lineSearch == "moreThuente") {
+      timeStep = wolfeLineSearch(c1, c2);
+    } else if (lineSearch == "backtrack") {
+      timeStep = backtrack(rho, c1);
+    } else {
+      mem3dg_runtime_error("lineSearch is either backtrack or moreThuente!");
+    }
+    pastStep = timeStep * flatten(f_velocity_e);
+    pastStep_protein = timeStep * toMatrix(system.proteinVelocity);
+    isStepPending = true;
+
+    // regularization and recompute cached values
+    if (system.meshProcessor.isMeshRegularize) {
+      system.computeRegularizationForce();
+      system.vpg->inputVertexPositions.raw() +=
+          system.forces.regularizationForce.raw();
+      system.updateConfigurations(false);
+    }
+  }
+}
+} // namespace integrator
+} // namespace solver
+} // namespace mem3dg
@@ -74,7 +74,7 @@ bool ConjugateGradient::integrate() {
     if (system.time - lastProcessMesh > processMeshPeriod) {
       lastProcessMesh = system.time;
       system.mutateMesh();
-      system.updateConfigurations(false);
+      system.updateMutatedConfigurations();
     }
 
     // update geodesics every tUpdateGeodesics period
@@ -134,6 +134,15 @@ void ConjugateGradient::checkParameters() {
     if (rho >= 1 || rho <= 0 || c1 >= 1 || c1 <= 0) {
       mem3dg_runtime_error("To backtrack, 0<rho<1 and 0<c1<1!");
     }
+    if (lineSearch != "backtrack" && lineSearch != "moreThuente") {
+      mem3dg_runtime_error("lineSearch is either backtrack or moreThuente!");
+    }
+    if (lineSearch == "moreThuente" && (c2 >= 1 || c2 <= c1)) {
+      mem3dg_runtime_error("For More-Thuente line search, c1<c2<1!");
+    }
+    if (stepGrowth < 1) {
+      mem3dg_runtime_error("stepGrowth >= 1 is required!");
+    }
   }
   if (restartPeriod < 1) {
     mem3dg_runtime_error("restartNum > 0!");
@@ -151,8 +160,8 @@ void ConjugateGradient::checkParameters() {
 void ConjugateGradient::status() {
   auto physicalForce = toMatrix(system.forces.mechanicalForce);
 
-  // compute summerized forces
-  system.computePhysicalForcing(timeStep);
+  // compute summerized forces and the free energy of the system
+  system.computePhysicalForcingAndEnergy(timeStep);
 
   // compute the area contraint error
   areaDifference = abs(system.surfaceArea / system.parameters.tension.At - 1);
@@ -175,9 +184,6 @@ void ConjugateGradient::status() {
     SUCCESS = false;
   }
 
-  // compute the free energy of the system
-  system.computeTotalEnergy();
-
   // backtracing for error
   finitenessErrorBacktrace();
 }
@@ -218,16 +224,20 @@ void ConjugateGradient::march() {
     updateAdaptiveCharacteristicStep();
   }
 
-  // time stepping on vertex position
-  if (isBacktrack) {
-    timeStep = backtrack(toMatrix(system.velocity),
-                         toMatrix(system.proteinVelocity), rho, c1);
+  // time stepping on vertex position, the line search takes the step
+  if (isBacktrack && lineSearch == "moreThuente") {
+    timeStep = wolfeLineSearch(c1, c2);
+  } else if (isBacktrack && lineSearch == "backtrack") {
+    timeStep = backtrack(rho, c1);
+  } else if (isBacktrack) {
+    mem3dg_runtime_error("lineSearch is either backtrack or moreThuente!");
   } else {
     timeStep = characteristicTimeStep;
+    toMatrix(system.vpg->inputVertexPositions) +=
+        timeStep * toMatrix(system.velocity);
+    system.proteinDensity.raw() += timeStep * system.proteinVelocity.raw();
+    system.time += timeStep;
   }
-  system.vpg->inputVertexPositions += system.velocity * timeStep;
-  system.proteinDensity += system.proteinVelocity * timeStep;
-  system.time += timeStep;
 
   // regularization
   if (system.meshProcessor.isMeshRegularize) {
@@ -236,8 +246,9 @@ void ConjugateGradient::march() {
         system.forces.regularizationForce.raw();
   }
 
-  // recompute cached values
-  system.updateConfigurations(false);
+  // recompute cached values, unless already done by the line search
+  if (!isBacktrack || system.meshProcessor.isMeshRegularize)
+    system.updateConfigurations(false);
 }
 
 } // namespace integrator
@@ -60,8 +60,8 @@ bool Euler::integrate() {
   for (;;) {
 
     // turn on/off self-avoidance; outside status-march-cycle; before savedata
-    // to write selfAvoidance
-    if (avoidStrength != 0) {
+    // to write selfAvoidance. Not needed with the Verlet list
+    if (avoidStrength != 0 && system.parameters.selfAvoidance.skin == 0) {
       if ((system.time - lastComputeAvoidingForce) >
               system.parameters.selfAvoidance.p * system.projectedCollideTime ||
           system.time - lastSave >= savePeriod || system.time == initialTime ||
@@ -99,9 +99,12 @@ bool Euler::integrate() {
     if (system.time - lastProcessMesh > (processMeshPeriod * timeStep)) {
       lastProcessMesh = system.time;
       system.mutateMesh();
-      if (system.meshProcessor.meshRegularizer.isSmoothenMesh)
+      if (system.meshProcessor.meshRegularizer.isSmoothenMesh) {
         system.smoothenMesh(timeStep);
-      system.updateConfigurations(false);
+        system.updateConfigurations(false);
+      } else {
+        system.updateMutatedConfigurations();
+      }
     }
 
     // update geodesics every tUpdateGeodesics period
@@ -150,12 +153,24 @@ void Euler::checkParameters() {
     if (rho >= 1 || rho <= 0 || c1 >= 1 || c1 <= 0) {
       mem3dg_runtime_error("To backtrack, 0<rho<1 and 0<c1<1!");
     }
+    if (lineSearch != "backtrack" && lineSearch != "moreThuente") {
+      mem3dg_runtime_error("lineSearch is either backtrack or moreThuente!");
+    }
+    if (lineSearch == "moreThuente" && (c2 >= 1 || c2 <= c1)) {
+      mem3dg_runtime_error("For More-Thuente line search, c1<c2<1!");
+    }
+    if (stepGrowth < 1) {
+      mem3dg_runtime_error("stepGrowth >= 1 is required!");
+    }
   }
 }
 
 void Euler::status() {
-  // compute summerized forces
-  system.computePhysicalForcing(timeStep);
+  // compute summerized forces and the free energy of the system, where the
+  // external work enters the total energy
+  if (system.parameters.external.Kf != 0)
+    system.computeExternalWork(system.time, timeStep);
+  system.computePhysicalForcingAndEnergy(timeStep);
 
   // compute the contraint error
   areaDifference = abs(system.surfaceArea / system.parameters.tension.At - 1);
@@ -178,11 +193,6 @@ void Euler::status() {
     SUCCESS = false;
   }
 
-  // compute the free energy of the system
-  if (system.parameters.external.Kf != 0)
-    system.computeExternalWork(system.time, timeStep);
-  system.computeTotalEnergy();
-
   // backtracking for error
   finitenessErrorBacktrace();
 }
@@ -198,22 +208,30 @@ void Euler::march() {
     characteristicTimeStep = updateAdaptiveCharacteristicStep();
   }
 
-  // time stepping on vertex position
-  if (isBacktrack) {
+  // time stepping on vertex position. The More-Thuente line search searches
+  // along both directions at once and takes the step
+  const bool isStepTaken = isBacktrack && lineSearch == "moreThuente";
+  if (isStepTaken) {
+    timeStep = wolfeLineSearch(c1, c2);
+  } else if (isBacktrack && lineSearch == "backtrack") {
     double timeStep_mech,
         timeStep_chem = std::numeric_limits<double>::infinity();
     if (system.parameters.variation.isShapeVariation)
-      timeStep_mech = mechanicalBacktrack(toMatrix(system.velocity), rho, c1);
+      timeStep_mech = mechanicalBacktrack(rho, c1);
     if (system.parameters.variation.isProteinVariation)
-      timeStep_chem =
-          chemicalBacktrack(toMatrix(system.proteinVelocity), rho, c1);
+      timeStep_chem = chemicalBacktrack(rho, c1);
     timeStep = (timeStep_chem < timeStep_mech) ? timeStep_chem : timeStep_mech;
+  } else if (isBacktrack) {
+    mem3dg_runtime_error("lineSearch is either backtrack or moreThuente!");
   } else {
     timeStep = characteristicTimeStep;
   }
-  system.vpg->inputVertexPositions += system.velocity * timeStep;
-  system.proteinDensity += system.proteinVelocity * timeStep;
-  system.time += timeStep;
+  if (!isStepTaken) {
+    toMatrix(system.vpg->inputVertexPositions) +=
+        timeStep * toMatrix(system.velocity);
+    system.proteinDensity.raw() += timeStep * system.proteinVelocity.raw();
+    system.time += timeStep;
+  }
 
   // regularization
   if (system.meshProcessor.isMeshRegularize) {
@@ -222,8 +240,9 @@ void Euler::march() {
         system.forces.regularizationForce.raw();
   }
 
-  // recompute cached values
-  system.updateConfigurations(false);
+  // recompute cached values, unless already done by the line search
+  if (!isStepTaken || system.meshProcessor.isMeshRegularize)
+    system.updateConfigurations(false);
 }
 } // namespace integrator
 } // namespace solver
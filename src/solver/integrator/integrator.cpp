@@ -18,6 +18,7 @@
 #include "mem3dg/type_utilities.h"
 #include "mem3dg/version.h"
 
+#include <algorithm>
 #include <cmath>
 #include <geometrycentral/utilities/eigen_interop_helpers.h>
 
@@ -29,6 +30,104 @@ namespace mem3dg {
 namespace solver {
 namespace integrator {
 
+// Safeguarded step of the More-Thuente line search (dcstep of MINPACK-2),
+// which updates the interval of uncertainty [stx, sty] and computes the next
+// trial step stp from the cubic or quadratic interpolant of the function
+// values f and the derivatives d
+static void moreThuenteStep(double &stx, double &fx, double &dx, double &sty,
+                            double &fy, double &dy, double &stp, double fp,
+                            double dp, bool &brackt, double stpmin,
+                            double stpmax) {
+  const double sgnd = dp * (dx / std::abs(dx));
+  double stpf;
+  if (fp > fx) {
+    // higher function value, the minimum is bracketed
+    double theta = 3 * (fx - fp) / (stp - stx) + dx + dp;
+    double s = std::max({std::abs(theta), std::abs(dx), std::abs(dp)});
+    double gamma = s * std::sqrt(std::pow(theta / s, 2) - (dx / s) * (dp / s));
+    if (stp < stx)
+      gamma = -gamma;
+    double p = (gamma - dx) + theta;
+    double q = ((gamma - dx) + gamma) + dp;
+    double stpc = stx + (p / q) * (stp - stx);
+    double stpq =
+        stx + ((dx / ((fx - fp) / (stp - stx) + dx)) / 2) * (stp - stx);
+    stpf = (std::abs(stpc - stx) < std::abs(stpq - stx))
+               ? stpc
+               : stpc + (stpq - stpc) / 2;
+    brackt = true;
+  } else if (sgnd < 0) {
+    // derivatives of opposite sign, the minimum is bracketed
+    double theta = 3 * (fx - fp) / (stp - stx) + dx + dp;
+    double s = std::max({std::abs(theta), std::abs(dx), std::abs(dp)});
+    double gamma = s * std::sqrt(std::pow(theta / s, 2) - (dx / s) * (dp / s));
+    if (stp > stx)
+      gamma = -gamma;
+    double p = (gamma - dp) + theta;
+    double q = ((gamma - dp) + gamma) + dx;
+    double stpc = stp + (p / q) * (stx - stp);
+    double stpq = stp + (dp / (dp - dx)) * (stx - stp);
+    stpf = (std::abs(stpc - stp) > std::abs(stpq - stp)) ? stpc : stpq;
+    brackt = true;
+  } else if (std::abs(dp) < std::abs(dx)) {
+    // derivative decreases in magnitude, use the cubic step only if it tends
+    // to infinity in the direction of the step or the minimum of the cubic is
+    // beyond stp
+    double theta = 3 * (fx - fp) / (stp - stx) + dx + dp;
+    double s = std::max({std::abs(theta), std::abs(dx), std::abs(dp)});
+    double gamma = s * std::sqrt(std::max(
+                           0.0, std::pow(theta / s, 2) - (dx / s) * (dp / s)));
+    if (stp > stx)
+      gamma = -gamma;
+    double p = (gamma - dp) + theta;
+    double q = (gamma + (dx - dp)) + gamma;
+    double r = p / q;
+    double stpc = (r < 0 && gamma != 0) ? stp + r * (stx - stp)
+                                        : (stp > stx ? stpmax : stpmin);
+    double stpq = stp + (dp / (dp - dx)) * (stx - stp);
+    if (brackt) {
+      stpf = (std::abs(stpc - stp) < std::abs(stpq - stp)) ? stpc : stpq;
+      stpf = (stp > stx) ? std::min(stp + 0.66 * (sty - stp), stpf)
+                         : std::max(stp + 0.66 * (sty - stp), stpf);
+    } else {
+      stpf = (std::abs(stpc - stp) > std::abs(stpq - stp)) ? stpc : stpq;
+      stpf = std::min(stpmax, std::max(stpmin, stpf));
+    }
+  } else {
+    // derivative does not decrease in magnitude
+    if (brackt) {
+      double theta = 3 * (fp - fy) / (sty - stp) + dy + dp;
+      double s = std::max({std::abs(theta), std::abs(dy), std::abs(dp)});
+      double gamma =
+          s * std::sqrt(std::pow(theta / s, 2) - (dy / s) * (dp / s));
+      if (stp > sty)
+        gamma = -gamma;
+      double p = (gamma - dp) + theta;
+      double q = ((gamma - dp) + gamma) + dy;
+      stpf = stp + (p / q) * (sty - stp);
+    } else {
+      stpf = (stp > stx) ? stpmax : stpmin;
+    }
+  }
+
+  // update the interval which contains the minimum
+  if (fp > fx) {
+    sty = stp;
+    fy = fp;
+    dy = dp;
+  } else {
+    if (sgnd < 0) {
+      sty = stx;
+      fy = fx;
+      dy = dx;
+    }
+    stx = stp;
+    fx = fp;
+    dx = dp;
+  }
+  stp = stpf;
+}
+
 double Integrator::updateAdaptiveCharacteristicStep() {
   double currentMinimumSize = system.vpg->edgeLengths.raw().minCoeff();
   double currentMaximumForce =
@@ -54,15 +153,29 @@ double Integrator::updateAdaptiveCharacteristicStep() {
   return dt;
 }
 
-double Integrator::backtrack(
-    Eigen::Matrix<double, Eigen::Dynamic, 3> &&positionDirection,
-    Eigen::Matrix<double, Eigen::Dynamic, 1> &&chemicalDirection, double rho,
-    double c1) {
+double Integrator::getInitialStep(double fraction) const {
+  return isWarmStartStep ? fraction * characteristicTimeStep
+                         : characteristicTimeStep;
+}
+
+void Integrator::updateStepMemory(double &fraction, double alpha,
+                                  std::size_t count) {
+  fraction = (count == 0) ? std::min(1.0, fraction * stepGrowth)
+                          : alpha / characteristicTimeStep;
+  lineSearchStatistics.nSearches++;
+  lineSearchStatistics.nInitialAcceptances += (count == 0);
+  lineSearchStatistics.nTrials += count + 1;
+}
+
+double Integrator::backtrack(double rho, double c1) {
 
   // cache energy of the last time step
   const Energy previousE = system.energy;
 
-  // validate the directions
+  // validate the directions, in place so that a replaced direction is seen
+  // by the caller
+  auto positionDirection = toMatrix(system.velocity);
+  auto &chemicalDirection = system.proteinVelocity.raw();
   double positionProjection = 0;
   double chemicalProjection = 0;
   if (system.parameters.variation.isShapeVariation) {
@@ -97,31 +210,53 @@ double Integrator::backtrack(
     }
   }
 
-  // calculate initial energy as reference level
-  gc::VertexData<gc::Vector3> initial_pos(*system.mesh);
-  initial_pos = system.vpg->inputVertexPositions;
-  gc::VertexData<double> initial_protein(*system.mesh,
-                                         system.proteinDensity.raw());
+  // initial configuration as reference level
+  initialPosition = toMatrix(system.vpg->inputVertexPositions);
+  initialProteinDensity = system.proteinDensity.raw();
   const double init_time = system.time;
 
+  // trial configuration of step size alpha, evaluated by the energy-only
+  // path if it covers the active energy terms, which leaves the system
+  // untouched
+  const bool isTrialEnergy = system.isTrialEnergySupported();
+  auto setTrialState = [&](double alpha) {
+    trialPosition = initialPosition;
+    trialProteinDensity = initialProteinDensity;
+    if (system.parameters.variation.isShapeVariation) {
+      trialPosition += alpha * positionDirection;
+    }
+    if (system.parameters.variation.isProteinVariation) {
+      trialProteinDensity += alpha * chemicalDirection;
+    }
+  };
+  auto applyTrialState = [&](double alpha) {
+    toMatrix(system.vpg->inputVertexPositions) = trialPosition;
+    system.proteinDensity.raw() = trialProteinDensity;
+    system.time = init_time + alpha;
+    system.updateConfigurations(false);
+  };
+  auto trialPotentialEnergy = [&](double alpha) {
+    ++nEnergyEvaluations;
+    setTrialState(alpha);
+    if (isTrialEnergy) {
+      return system.computeTrialPotentialEnergy(trialPosition,
+                                                trialProteinDensity);
+    }
+    applyTrialState(alpha);
+    return system.computePotentialEnergy();
+  };
+
   // declare variables used in backtracking iterations
-  double alpha = characteristicTimeStep;
+  double alpha = getInitialStep(stepFraction);
   std::size_t count = 0;
+  bool isFailure = false;
 
   // zeroth iteration
-  if (system.parameters.variation.isShapeVariation) {
-    toMatrix(system.vpg->inputVertexPositions) += alpha * positionDirection;
-  }
-  if (system.parameters.variation.isProteinVariation) {
-    system.proteinDensity.raw() += alpha * chemicalDirection;
-  }
-  system.time += alpha;
-  system.updateConfigurations(false);
-  system.computePotentialEnergy();
+  double potentialEnergy = trialPotentialEnergy(alpha);
 
   while (true) {
     // Wolfe condition fulfillment
-    if (system.energy.potentialEnergy <
+    if (potentialEnergy <
         (previousE.potentialEnergy + system.computeIntegratedPower(alpha) -
          c1 * alpha * (positionProjection + chemicalProjection))) {
       break;
@@ -131,32 +266,25 @@ double Integrator::backtrack(
     if (alpha < 1e-5 * characteristicTimeStep) {
       mem3dg_runtime_message("line search failure! Simulation "
                              "stopped. \n");
+      if (isTrialEnergy)
+        applyTrialState(alpha);
       std::cout << "\nError backtrace using alpha: \n" << std::endl;
-      lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                               toMatrix(initial_protein), previousE, true);
+      lineSearchErrorBacktrace(alpha, initialPosition, initialProteinDensity,
+                               previousE, true);
       std::cout << "\nError backtrace using characteristicTimeStep: \n"
                 << std::endl;
       lineSearchErrorBacktrace(characteristicTimeStep,
                                toMatrix(system.vpg->inputVertexPositions),
-                               toMatrix(initial_protein), previousE, true);
+                               initialProteinDensity, previousE, true);
       EXIT = true;
       SUCCESS = false;
+      isFailure = true;
       break;
     }
 
     // backtracking time step
     alpha *= rho;
-    if (system.parameters.variation.isShapeVariation) {
-      toMatrix(system.vpg->inputVertexPositions) =
-          toMatrix(initial_pos) + alpha * positionDirection;
-    }
-    if (system.parameters.variation.isProteinVariation) {
-      system.proteinDensity.raw() =
-          toMatrix(initial_protein) + alpha * chemicalDirection;
-    }
-    system.time = init_time + alpha;
-    system.updateConfigurations(false);
-    system.computePotentialEnergy();
+    potentialEnergy = trialPotentialEnergy(alpha);
 
     // count the number of iterations
     count++;
@@ -170,29 +298,232 @@ double Integrator::backtrack(
     // std::cout << "chem norm: " << system.chemErrorNorm << std::endl;
   }
 
+  // remember the accepted step for the next line search
+  if (!isFailure)
+    updateStepMemory(stepFraction, alpha, count);
+
   // If needed to test force-energy test
   const bool isDebug = false;
   if (isDebug) {
-    lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                             toMatrix(initial_protein), previousE, isDebug);
+    lineSearchErrorBacktrace(alpha, initialPosition, initialProteinDensity,
+                             previousE, isDebug);
+    isFailure = true;
   }
 
-  // recover the initial configuration
-  system.time = init_time;
-  system.proteinDensity = initial_protein;
-  system.vpg->inputVertexPositions = initial_pos;
-  system.updateConfigurations(false);
-  system.computePotentialEnergy();
+  // commit the accepted step, which the last trial already did unless
+  // evaluated by the energy-only path or perturbed by the error backtrace
+  if (isTrialEnergy || isFailure) {
+    setTrialState(alpha);
+    applyTrialState(alpha);
+  }
   return alpha;
 }
-double Integrator::chemicalBacktrack(
-    Eigen::Matrix<double, Eigen::Dynamic, 1> &&chemicalDirection, double rho,
-    double c1) {
+
+double Integrator::wolfeLineSearch(double c1, double c2) {
+  if (!(0 < c1 && c1 < c2 && c2 < 1))
+    mem3dg_runtime_error("wolfeLineSearch: 0 < c1 < c2 < 1 is required!");
 
   // cache energy of the last time step
   const Energy previousE = system.energy;
 
-  // validate the directions
+  // validate the directions, in place so that a replaced direction is seen
+  // by the caller
+  auto positionDirection = toMatrix(system.velocity);
+  auto &chemicalDirection = system.proteinVelocity.raw();
+  double positionProjection = 0;
+  double chemicalProjection = 0;
+  if (system.parameters.variation.isShapeVariation) {
+    positionProjection = (toMatrix(system.forces.mechanicalForceVec).array() *
+                          positionDirection.array())
+                             .sum();
+    if (positionProjection < 0) {
+      std::cout << "\nWolfe line search: positional velocity on uphill "
+                   "direction, use bare gradient! \n"
+                << std::endl;
+      positionDirection = toMatrix(system.forces.mechanicalForceVec);
+      positionProjection = positionDirection.squaredNorm();
+    }
+  }
+  if (system.parameters.variation.isProteinVariation) {
+    chemicalProjection = (system.forces.chemicalPotential.raw().array() *
+                          chemicalDirection.array())
+                             .sum();
+    if (chemicalProjection < 0) {
+      std::cout << "\nWolfe line search: chemical direction on uphill "
+                   "direction, use bare gradient! \n"
+                << std::endl;
+      chemicalDirection = system.forces.chemicalPotential.raw();
+      chemicalProjection = chemicalDirection.squaredNorm();
+    }
+  }
+
+  // initial configuration as reference level
+  initialPosition = toMatrix(system.vpg->inputVertexPositions);
+  initialProteinDensity = system.proteinDensity.raw();
+  const double init_time = system.time;
+
+  // take the trial step of size alpha, and evaluate the objective, i.e. the
+  // potential energy less the external work, and its derivative along the
+  // directions, -forces·direction. The directional derivative needs the
+  // forces, hence the trial is always evaluated on the system
+  double evaluatedAlpha = 0;
+  auto evaluate = [&](double alpha, double &objective, double &derivative) {
+    ++nEnergyEvaluations;
+    evaluatedAlpha = alpha;
+    toMatrix(system.vpg->inputVertexPositions) = initialPosition;
+    system.proteinDensity.raw() = initialProteinDensity;
+    if (system.parameters.variation.isShapeVariation) {
+      toMatrix(system.vpg->inputVertexPositions) += alpha * positionDirection;
+    }
+    if (system.parameters.variation.isProteinVariation) {
+      system.proteinDensity.raw() += alpha * chemicalDirection;
+    }
+    system.time = init_time + alpha;
+    system.updateConfigurations(false);
+    system.computePhysicalForcing();
+    objective = system.computePotentialEnergy() -
+                system.computeIntegratedPower(alpha);
+    derivative = 0;
+    if (system.parameters.variation.isShapeVariation) {
+      derivative -= (toMatrix(system.forces.mechanicalForceVec).array() *
+                     positionDirection.array())
+                        .sum();
+    }
+    if (system.parameters.variation.isProteinVariation) {
+      derivative -= (system.forces.chemicalPotential.raw().array() *
+                     chemicalDirection.array())
+                        .sum();
+    }
+  };
+
+  // More-Thuente line search (dcsrch of MINPACK-2) for the strong Wolfe
+  // conditions, starting from characteristicTimeStep
+  const double stpmin = 1e-5 * characteristicTimeStep;
+  const double stpmax = characteristicTimeStep;
+  const double xtol = 0.1;
+  const std::size_t maxEvaluations = 20;
+  const double finit = previousE.potentialEnergy;
+  const double ginit = -(positionProjection + chemicalProjection);
+  const double gtest = c1 * ginit;
+  bool brackt = false;
+  bool isFirstStage = true;
+  double width = stpmax - stpmin, width1 = 2 * width;
+  double stx = 0, fx = finit, gx = ginit;
+  double sty = 0, fy = finit, gy = ginit;
+  double stmin = 0, stmax = 5 * characteristicTimeStep;
+  double alpha = characteristicTimeStep;
+  double upper = stpmax;
+  double f = finit, g = ginit;
+  bool isConverged = false;
+
+  for (std::size_t count = 0; count < maxEvaluations; ++count) {
+    evaluate(alpha, f, g);
+    const double ftest = finit + alpha * gtest;
+
+    // non-finite trial, bound the steps and shrink toward the best step
+    if (!std::isfinite(f) || !std::isfinite(g)) {
+      upper = alpha;
+      alpha = stx + 0.5 * (alpha - stx);
+      if (alpha < stpmin)
+        break;
+      continue;
+    }
+
+    // strong Wolfe conditions
+    if (f <= ftest && std::abs(g) <= -c2 * ginit) {
+      isConverged = true;
+      break;
+    }
+
+    // no further progress within the bounds and tolerance
+    if ((brackt && (alpha <= stmin || alpha >= stmax)) ||
+        (brackt && stmax - stmin <= xtol * stmax) ||
+        (alpha == stpmax && f <= ftest && g <= gtest) ||
+        (alpha == stpmin && (f > ftest || g >= gtest)))
+      break;
+
+    // the first stage works on the modified function f - gtest * alpha until
+    // it has a nonpositive value and a nonnegative derivative
+    if (isFirstStage && f <= ftest && g >= std::min(c1, c2) * ginit)
+      isFirstStage = false;
+    if (isFirstStage && f <= fx && f > ftest) {
+      double fm = f - alpha * gtest, gm = g - gtest;
+      double fxm = fx - stx * gtest, gxm = gx - gtest;
+      double fym = fy - sty * gtest, gym = gy - gtest;
+      moreThuenteStep(stx, fxm, gxm, sty, fym, gym, alpha, fm, gm, brackt,
+                      stmin, stmax);
+      fx = fxm + stx * gtest;
+      fy = fym + sty * gtest;
+      gx = gxm + gtest;
+      gy = gym + gtest;
+    } else {
+      moreThuenteStep(stx, fx, gx, sty, fy, gy, alpha, f, g, brackt, stmin,
+                      stmax);
+    }
+
+    // force sufficient decrease of the interval of uncertainty
+    if (brackt) {
+      if (std::abs(sty - stx) >= 0.66 * width1)
+        alpha = stx + 0.5 * (sty - stx);
+      width1 = width;
+      width = std::abs(sty - stx);
+      stmin = std::min(stx, sty);
+      stmax = std::max(stx, sty);
+    } else {
+      stmin = alpha + 1.1 * (alpha - stx);
+      stmax = alpha + 4 * (alpha - stx);
+    }
+    alpha = std::min(std::max(alpha, stpmin), stpmax);
+    if (alpha >= upper)
+      alpha = stx + 0.5 * (upper - stx);
+    if ((brackt && (alpha <= stmin || alpha >= stmax)) ||
+        (brackt && stmax - stmin <= xtol * stmax))
+      alpha = stx;
+  }
+
+  // without the strong Wolfe conditions, accept the last trial or the best
+  // step so far if either has sufficient decrease, fx being the objective at
+  // stx
+  if (!isConverged) {
+    if (std::isfinite(f) && f <= finit + evaluatedAlpha * gtest) {
+      alpha = evaluatedAlpha;
+      isConverged = true;
+    } else if (stx > 0 && fx <= finit + stx * gtest) {
+      alpha = stx;
+      evaluate(alpha, f, g);
+      isConverged = true;
+    } else {
+      alpha = evaluatedAlpha;
+    }
+  }
+  if (!isConverged) {
+    mem3dg_runtime_message("\nWolfe line search: line search failure! "
+                           "Simulation stopped. \n");
+    std::cout << "\nError backtrace using alpha: \n" << std::endl;
+    lineSearchErrorBacktrace(alpha, initialPosition, initialProteinDensity,
+                             previousE, true);
+    EXIT = true;
+    SUCCESS = false;
+    // recover the trial step perturbed by the error backtrace
+    evaluate(alpha, f, g);
+  }
+
+  // report the line search if verbose
+  if (alpha != characteristicTimeStep && verbosity > 3) {
+    std::cout << "alpha: " << characteristicTimeStep << " -> " << alpha
+              << std::endl;
+  }
+  return alpha;
+}
+
+double Integrator::chemicalBacktrack(double rho, double c1) {
+
+  // cache energy of the last time step
+  const Energy previousE = system.energy;
+
+  // validate the directions, in place so that a replaced direction is seen
+  // by the caller
+  auto &chemicalDirection = system.proteinVelocity.raw();
   double chemicalProjection = 0;
   chemicalProjection = (system.forces.chemicalPotential.raw().array() *
                         chemicalDirection.array())
@@ -209,26 +540,42 @@ double Integrator::chemicalBacktrack(
                              .sum();
   }
 
-  // calculate initial energy as reference level
-  gc::VertexData<gc::Vector3> initial_pos(*system.mesh);
-  initial_pos = system.vpg->inputVertexPositions;
-  gc::VertexData<double> initial_protein(*system.mesh,
-                                         system.proteinDensity.raw());
+  // initial configuration as reference level
+  initialPosition = toMatrix(system.vpg->inputVertexPositions);
+  initialProteinDensity = system.proteinDensity.raw();
   const double init_time = system.time;
 
+  // trial configuration of step size alpha, evaluated by the energy-only
+  // path if it covers the active energy terms, which leaves the system
+  // untouched
+  const bool isTrialEnergy = system.isTrialEnergySupported();
+  auto applyTrialState = [&](double alpha) {
+    system.proteinDensity.raw() = trialProteinDensity;
+    system.time = init_time + alpha;
+    system.updateConfigurations(false);
+  };
+  auto trialPotentialEnergy = [&](double alpha) {
+    ++nEnergyEvaluations;
+    trialProteinDensity = initialProteinDensity + alpha * chemicalDirection;
+    if (isTrialEnergy) {
+      return system.computeTrialPotentialEnergy(initialPosition,
+                                                trialProteinDensity);
+    }
+    applyTrialState(alpha);
+    return system.computePotentialEnergy();
+  };
+
   // declare variables used in backtracking iterations
-  double alpha = characteristicTimeStep;
+  double alpha = getInitialStep(chemicalStepFraction);
   std::size_t count = 0;
+  bool isFailure = false;
 
   // zeroth iteration
-  system.proteinDensity.raw() += alpha * chemicalDirection;
-  system.time += alpha;
-  system.updateConfigurations(false);
-  system.computePotentialEnergy();
+  double potentialEnergy = trialPotentialEnergy(alpha);
 
   while (true) {
     // Wolfe condition fulfillment
-    if (system.energy.potentialEnergy <
+    if (potentialEnergy <
         (previousE.potentialEnergy - c1 * alpha * chemicalProjection)) {
       break;
     }
@@ -238,25 +585,24 @@ double Integrator::chemicalBacktrack(
       mem3dg_runtime_message(
           "\nchemicalBacktrack: line search failure! Simulation "
           "stopped. \n");
+      if (isTrialEnergy)
+        applyTrialState(alpha);
       std::cout << "\nError backtrace using alpha: \n" << std::endl;
-      lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                               toMatrix(initial_protein), previousE, true);
+      lineSearchErrorBacktrace(alpha, initialPosition, initialProteinDensity,
+                               previousE, true);
       std::cout << "\nError backtrace using characteristicTimeStep: \n"
                 << std::endl;
-      lineSearchErrorBacktrace(characteristicTimeStep, toMatrix(initial_pos),
-                               toMatrix(initial_protein), previousE, true);
+      lineSearchErrorBacktrace(characteristicTimeStep, initialPosition,
+                               initialProteinDensity, previousE, true);
       EXIT = true;
       SUCCESS = false;
+      isFailure = true;
       break;
     }
 
     // backtracking time step
     alpha *= rho;
-    system.proteinDensity.raw() =
-        toMatrix(initial_protein) + alpha * chemicalDirection;
-    system.time = init_time + alpha;
-    system.updateConfigurations(false);
-    system.computePotentialEnergy();
+    potentialEnergy = trialPotentialEnergy(alpha);
 
     // count the number of iterations
     count++;
@@ -268,31 +614,34 @@ double Integrator::chemicalBacktrack(
               << std::endl;
   }
 
+  // remember the accepted step for the next line search
+  if (!isFailure)
+    updateStepMemory(chemicalStepFraction, alpha, count);
+
   // If needed to test force-energy test
   const bool isDebug = false;
   if (isDebug) {
     std::cout << "\nchemicalBacktrack: debugging \n" << std::endl;
-    lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                             toMatrix(initial_protein), previousE, isDebug);
+    lineSearchErrorBacktrace(alpha, initialPosition, initialProteinDensity,
+                             previousE, isDebug);
   }
 
-  // recover the initial configuration
+  // recover the initial configuration without refreshing, which is left to
+  // the caller after taking the step
   system.time = init_time;
-  system.proteinDensity = initial_protein;
-  system.vpg->inputVertexPositions = initial_pos;
-  system.updateConfigurations(false);
-  system.computePotentialEnergy();
+  system.energy = previousE;
+  system.proteinDensity.raw() = initialProteinDensity;
+  toMatrix(system.vpg->inputVertexPositions) = initialPosition;
   return alpha;
 }
 
-double Integrator::mechanicalBacktrack(
-    Eigen::Matrix<double, Eigen::Dynamic, 3> &&positionDirection, double rho,
-    double c1) {
+double Integrator::mechanicalBacktrack(double rho, double c1) {
 
   // cache energy of the last time step
   const Energy previousE = system.energy;
 
   // validate the directions
+  auto positionDirection = toMatrix(system.velocity);
   double positionProjection = 0;
   positionProjection = (toMatrix(system.forces.mechanicalForceVec).array() *
                         positionDirection.array())
@@ -309,29 +658,45 @@ double Integrator::mechanicalBacktrack(
                              .sum();
   }
 
-  // calculate initial energy as reference level
-  gc::VertexData<gc::Vector3> initial_pos(*system.mesh);
-  initial_pos = system.vpg->inputVertexPositions;
-  gc::VertexData<double> initial_protein(*system.mesh,
-                                         system.proteinDensity.raw());
+  // initial configuration as reference level
+  initialPosition = toMatrix(system.vpg->inputVertexPositions);
+  initialProteinDensity = system.proteinDensity.raw();
   const double init_time = system.time;
 
+  // trial configuration of step size alpha, evaluated by the energy-only
+  // path if it covers the active energy terms, which leaves the system
+  // untouched
+  const bool isTrialEnergy = system.isTrialEnergySupported();
+  auto applyTrialState = [&](double alpha) {
+    toMatrix(system.vpg->inputVertexPositions) = trialPosition;
+    system.time = init_time + alpha;
+    system.updateConfigurations(false);
+  };
+  auto trialPotentialEnergy = [&](double alpha) {
+    ++nEnergyEvaluations;
+    trialPosition = initialPosition + alpha * positionDirection;
+    if (isTrialEnergy) {
+      return system.computeTrialPotentialEnergy(trialPosition,
+                                                initialProteinDensity);
+    }
+    applyTrialState(alpha);
+    return system.computePotentialEnergy();
+  };
+
   // declare variables used in backtracking iterations
-  double alpha = characteristicTimeStep;
+  double alpha = getInitialStep(mechanicalStepFraction);
   std::size_t count = 0;
+  bool isFailure = false;
 
   // zeroth iteration
-  toMatrix(system.vpg->inputVertexPositions) += alpha * positionDirection;
-  system.time += alpha;
-  system.updateConfigurations(false);
-  system.computePotentialEnergy();
+  double potentialEnergy = trialPotentialEnergy(alpha);
 
   while (true) {
     // Wolfe condition fulfillment
-    if ((system.energy.potentialEnergy <
+    if ((potentialEnergy <
          (previousE.potentialEnergy + system.computeIntegratedPower(alpha) -
           c1 * alpha * positionProjection)) &&
-        std::isfinite(system.energy.potentialEnergy)) {
+        std::isfinite(potentialEnergy)) {
       break;
     }
 
@@ -340,26 +705,24 @@ double Integrator::mechanicalBacktrack(
       mem3dg_runtime_message(
           "\nmechanicalBacktrack: line search failure! Simulation "
           "stopped. \n");
+      if (isTrialEnergy)
+        applyTrialState(alpha);
       std::cout << "\nError backtrace using alpha: \n" << std::endl;
-      lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                               toMatrix(initial_protein), previousE, true);
+      lineSearchErrorBacktrace(alpha, initialPosition, initialProteinDensity,
+                               previousE, true);
       std::cout << "\nError backtrace using characterisiticTimeStep: \n"
                 << std::endl;
-      lineSearchErrorBacktrace(characteristicTimeStep, toMatrix(initial_pos),
-                               toMatrix(initial_protein), previousE, true);
+      lineSearchErrorBacktrace(characteristicTimeStep, initialPosition,
+                               initialProteinDensity, previousE, true);
       EXIT = true;
       SUCCESS = false;
+      isFailure = true;
       break;
     }
 
     // backtracking time step
     alpha *= rho;
-    toMatrix(system.vpg->inputVertexPositions) =
-        toMatrix(initial_pos) + alpha * positionDirection;
-
-    system.time = init_time + alpha;
-    system.updateConfigurations(false);
-    system.computePotentialEnergy();
+    potentialEnergy = trialPotentialEnergy(alpha);
 
     // count the number of iterations
     count++;
@@ -371,20 +734,24 @@ double Integrator::mechanicalBacktrack(
               << std::endl;
   }
 
+  // remember the accepted step for the next line search
+  if (!isFailure)
+    updateStepMemory(mechanicalStepFraction, alpha, count);
+
   // If needed to test force-energy test
   const bool isDebug = false;
   if (isDebug) {
     std::cout << "\nmechanicalBacktrack: debugging \n" << std::endl;
-    lineSearchErrorBacktrace(alpha, toMatrix(initial_pos),
-                             toMatrix(initial_protein), previousE, isDebug);
+    lineSearchErrorBacktrace(alpha, initialPosition, initialProteinDensity,
+                             previousE, isDebug);
   }
 
-  // recover the initial configuration
+  // recover the initial configuration without refreshing, which is left to
+  // the caller after taking the step
   system.time = init_time;
-  system.proteinDensity = initial_protein;
-  system.vpg->inputVertexPositions = initial_pos;
-  system.updateConfigurations(false);
-  system.computePotentialEnergy();
+  system.energy = previousE;
+  system.proteinDensity.raw() = initialProteinDensity;
+  toMatrix(system.vpg->inputVertexPositions) = initialPosition;
   return alpha;
 }
 
@@ -394,6 +761,19 @@ void Integrator::lineSearchErrorBacktrace(
     bool runAll) {
   std::cout << "\nlineSearchErrorBacktracking ..." << std::endl;
 
+  // lean mode: decompose the forces at the initial configuration
+  if (!system.isDecomposeForces) {
+    EigenVectorX3dr trialPosition = toMatrix(system.vpg->inputVertexPositions);
+    EigenVectorX1d trialProteinDensity = system.proteinDensity.raw();
+    system.proteinDensity.raw() = currentProteinDensity;
+    toMatrix(system.vpg->inputVertexPositions) = currentPosition;
+    system.updateConfigurations(false);
+    system.computeDecomposedForces();
+    system.proteinDensity.raw() = trialProteinDensity;
+    toMatrix(system.vpg->inputVertexPositions) = trialPosition;
+    system.updateConfigurations(false);
+  }
+
   // cache the energy when applied the total force
   // system.proteinDensity.raw() = currentProteinDensity;
   // toMatrix(system.vpg->inputVertexPositions) =
@@ -893,6 +1273,8 @@ void Integrator::finitenessErrorBacktrace() {
     }
 
     if (!std::isfinite(toMatrix(system.forces.mechanicalForceVec).norm())) {
+      if (!system.isDecomposeForces)
+        system.computeDecomposedForces();
       if (!std::isfinite(toMatrix(system.forces.capillaryForceVec).norm())) {
         mem3dg_runtime_message("Capillary force is not finite!");
       }
@@ -1087,6 +1469,10 @@ void Integrator::saveData() {
   // threshold of verbosity level to output ply file
   int outputPly = 0;
 
+  // lean mode: decompose the forces for output
+  if (!system.isDecomposeForces)
+    system.computeDecomposedForces();
+
 #ifdef MEM3DG_WITH_NETCDF
   // save variable to netcdf traj file
   if (verbosity > 0) {
@@ -1151,7 +1537,16 @@ void Integrator::saveData() {
     // 3>(f.vpg->inputVertexPositions).colwise().sum() /
     //         f.vpg->inputVertexPositions.raw().rows()
     // << "\n"
+    if (lineSearchStatistics.nSearches > 0) {
+      std::cout << "line search: " << lineSearchStatistics.nInitialAcceptances
+                << "/" << lineSearchStatistics.nSearches
+                << " accepted at initial step, "
+                << (double)lineSearchStatistics.nTrials /
+                       lineSearchStatistics.nSearches
+                << " trials per search" << std::endl;
+    }
   }
+  lineSearchStatistics = LineSearchStatistics();
   // break loop if EXIT flag is on
   if (EXIT) {
     if (verbosity > 0) {
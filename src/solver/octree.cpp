@@ -0,0 +1,119 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#include "mem3dg/solver/octree.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace mem3dg {
+namespace solver {
+
+constexpr std::size_t Octree::INVALID_IND;
+constexpr std::size_t Octree::LEAF_SIZE;
+constexpr std::size_t Octree::MAX_DEPTH;
+
+void Octree::build(const gcs::VertexData<gc::Vector3> &positions,
+                   const gcs::VertexData<double> &weights) {
+  const std::size_t n = positions.size();
+  nodes.clear();
+  vertices.resize(n);
+  std::iota(vertices.begin(), vertices.end(), 0);
+  if (n == 0)
+    return;
+
+  // cubic bounding box
+  gc::Vector3 lower = positions[0], upper = positions[0];
+  for (std::size_t i = 1; i < n; ++i) {
+    const gc::Vector3 &x = positions[i];
+    lower = {std::min(lower.x, x.x), std::min(lower.y, x.y),
+             std::min(lower.z, x.z)};
+    upper = {std::max(upper.x, x.x), std::max(upper.y, x.y),
+             std::max(upper.z, x.z)};
+  }
+  gc::Vector3 extent = upper - lower;
+
+  Node root;
+  root.center = 0.5 * (lower + upper);
+  root.halfSize = 0.5 * std::max({extent.x, extent.y, extent.z});
+  root.begin = 0;
+  root.end = n;
+  nodes.push_back(root);
+  subdivide(0, 0, positions, weights);
+}
+
+void Octree::subdivide(std::size_t nodeInd, std::size_t depth,
+                       const gcs::VertexData<gc::Vector3> &positions,
+                       const gcs::VertexData<double> &weights) {
+  // nodes may reallocate below, hence copy instead of reference
+  Node node = nodes[nodeInd];
+
+  // monopole
+  double weight = 0;
+  gc::Vector3 moment{0, 0, 0};
+  for (std::size_t k = node.begin; k < node.end; ++k) {
+    weight += weights[vertices[k]];
+    moment += weights[vertices[k]] * positions[vertices[k]];
+  }
+  node.weight = weight;
+  node.weightedCenter = (weight != 0) ? moment / weight : node.center;
+  node.firstChild = INVALID_IND;
+  node.nChildren = 0;
+  nodes[nodeInd] = node;
+  if (node.end - node.begin <= LEAF_SIZE || depth == MAX_DEPTH)
+    return;
+
+  // stable counting sort into octants, so leaves list vertices in ascending
+  // order
+  auto octant = [&](std::size_t i) {
+    const gc::Vector3 &x = positions[i];
+    return (x.x >= node.center.x) | ((x.y >= node.center.y) << 1) |
+           ((x.z >= node.center.z) << 2);
+  };
+  std::size_t offsets[9] = {0};
+  for (std::size_t k = node.begin; k < node.end; ++k)
+    ++offsets[octant(vertices[k]) + 1];
+  for (std::size_t o = 0; o < 8; ++o)
+    offsets[o + 1] += offsets[o];
+  std::vector<std::size_t> sorted(node.end - node.begin);
+  std::size_t fill[8];
+  std::copy(offsets, offsets + 8, fill);
+  for (std::size_t k = node.begin; k < node.end; ++k)
+    sorted[fill[octant(vertices[k])]++] = vertices[k];
+  std::copy(sorted.begin(), sorted.end(), vertices.begin() + node.begin);
+
+  // children are contiguous
+  const std::size_t firstChild = nodes.size();
+  for (std::size_t o = 0; o < 8; ++o) {
+    if (offsets[o + 1] == offsets[o])
+      continue;
+    Node child;
+    double quarter = 0.5 * node.halfSize;
+    child.center = node.center + gc::Vector3{(o & 1) ? quarter : -quarter,
+                                             (o & 2) ? quarter : -quarter,
+                                             (o & 4) ? quarter : -quarter};
+    child.halfSize = quarter;
+    child.begin = node.begin + offsets[o];
+    child.end = node.begin + offsets[o + 1];
+    nodes.push_back(child);
+  }
+  nodes[nodeInd].firstChild = firstChild;
+  nodes[nodeInd].nChildren = nodes.size() - firstChild;
+  for (std::size_t c = firstChild; c < firstChild + nodes[nodeInd].nChildren;
+       ++c)
+    subdivide(c, depth + 1, positions, weights);
+}
+
+} // namespace solver
+} // namespace mem3dg
@@ -13,6 +13,7 @@
 //
 #include "mem3dg/solver/parameters.h"
 #include "mem3dg/macros.h"
+#include <algorithm>
 #include <cstddef>
 
 namespace gc = ::geometrycentral;
@@ -98,6 +99,12 @@ void Parameters::Point::checkParameters() {
     //             << std::endl;
     // }
   }
+  if (geodesicTolerance < 0) {
+    mem3dg_runtime_error("Geodesic tolerance has to be >= 0!");
+  }
+  if (geodesicRadius < 0) {
+    mem3dg_runtime_error("Geodesic radius has to be >= 0!");
+  }
 }
 
 void Parameters::ProteinDistribution::checkParameters(size_t nVertex) {
@@ -147,10 +154,40 @@ void Parameters::Variation::checkParameters() {
   }
 }
 
+void Parameters::SelfAvoidance::checkParameters() {
+  if (n > 2) {
+    mem3dg_runtime_error("Self avoidance excludes at most 2 neighbor layers!");
+  }
+  if (cutoff < 0) {
+    mem3dg_runtime_error("Self avoidance cutoff has to be >= 0!");
+  }
+  if (cutoff != 0 && cutoff <= d) {
+    mem3dg_runtime_error(
+        "Self avoidance cutoff has to be greater than the limit distance d!");
+  }
+  if (skin < 0) {
+    mem3dg_runtime_error("Self avoidance skin has to be >= 0!");
+  }
+  if (skin != 0 && cutoff == 0) {
+    mem3dg_runtime_error("Self avoidance skin requires a cutoff!");
+  }
+  if (theta < 0) {
+    mem3dg_runtime_error("Self avoidance opening angle theta has to be >= 0!");
+  }
+  if (theta != 0 && cutoff != 0) {
+    mem3dg_runtime_error("Self avoidance tree code (theta) and cutoff can not "
+                         "be used together!");
+  }
+  if (isFaceContact && cutoff == 0) {
+    mem3dg_runtime_error("Self avoidance face contact requires a cutoff!");
+  }
+}
+
 void Parameters::checkParameters(bool hasBoundary, size_t nVertex) {
   tension.checkParameters();
   osmotic.checkParameters();
   variation.checkParameters();
+  selfAvoidance.checkParameters();
   point.checkParameters();
   proteinDistribution.checkParameters(nVertex);
 
@@ -170,6 +207,16 @@ void Parameters::checkParameters(bool hasBoundary, size_t nVertex) {
     }
   }
 
+  // the local geodesic update clamps the distance at the radius
+  if (point.geodesicRadius != 0 &&
+      proteinDistribution.typeOfProtein0 ==
+          ProteinDistribution::GeodesicPhaseSeparation &&
+      point.geodesicRadius <= std::max(proteinDistribution.protein0[0],
+                                       proteinDistribution.protein0[1])) {
+    mem3dg_runtime_error("Geodesic radius has to be 0 or larger than the "
+                         "radii of the protein0 profile!");
+  }
+
   if (variation.isProteinVariation != (proteinMobility > 0)) {
     mem3dg_runtime_error("proteinMobility value has to be consistent with the "
                          "protein variation option!");
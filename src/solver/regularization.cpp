@@ -17,6 +17,7 @@
 #include "geometrycentral/utilities/vector3.h"
 #include "mem3dg/constants.h"
 #include "mem3dg/meshops.h"
+#include "mem3dg/parallel.h"
 #include "mem3dg/solver/system.h"
 #include <Eigen/Core>
 #include <cmath>
@@ -30,57 +31,64 @@ namespace gcs = ::geometrycentral::surface;
 void System::computeRegularizationForce() {
   // Note in regularization, it is preferred to use immediate calculation rather
   // than cached one
-  for (gcs::Vertex v : mesh->vertices()) {
-    if (!v.isBoundary()) {
-      for (gcs::Halfedge he : v.outgoingHalfedges()) {
-        gcs::Edge e = he.edge();
-        // Conformal regularization
-        if (meshProcessor.meshRegularizer.Kst != 0 && !e.isBoundary()) {
-          gcs::Halfedge jl = he.next();
-          gcs::Halfedge li = jl.next();
-          gcs::Halfedge ik = he.twin().next();
-          gcs::Halfedge kj = ik.next();
-
-          gc::Vector3 grad_li = vecFromHalfedge(li, *vpg).normalize();
-          gc::Vector3 grad_ik = vecFromHalfedge(ik.twin(), *vpg).normalize();
-          forces.regularizationForce[v] +=
-              -meshProcessor.meshRegularizer.Kst *
-              (meshProcessor.meshRegularizer.computeLengthCrossRatio(*vpg, e) -
-               meshProcessor.meshRegularizer.refLcrs[e.getIndex()]) /
-              meshProcessor.meshRegularizer.refLcrs[e.getIndex()] *
-              (vpg->edgeLength(kj.edge()) / vpg->edgeLength(jl.edge())) *
-              (grad_li * vpg->edgeLength(ik.edge()) -
-               grad_ik * vpg->edgeLength(li.edge())) /
-              vpg->edgeLength(ik.edge()) / vpg->edgeLength(ik.edge());
-        }
+  const Connectivity &cn = connectivity;
+  const gcs::VertexData<gc::Vector3> &pos = vpg->inputVertexPositions;
+  const MeshProcessor::MeshRegularizer &regularizer =
+      meshProcessor.meshRegularizer;
+
+  const std::ptrdiff_t nVertices = mesh->nVertices();
+#ifdef MEM3DG_WITH_OPENMP
+#pragma omp parallel for schedule(static) num_threads(getNumThreads(nThreads))
+#endif
+  for (std::ptrdiff_t i = 0; i < nVertices; ++i) {
+    if (cn.isBoundaryVertex(i))
+      continue;
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k) {
+      std::size_t he = cn.outgoingHalfedges[k];
+      std::size_t e = cn.halfedgeEdge[he];
+      // Conformal regularization
+      if (regularizer.Kst != 0 && !cn.isBoundaryEdge(he)) {
+        std::size_t jl = cn.halfedgeNext[he];
+        std::size_t li = cn.halfedgeNext[jl];
+        std::size_t ik = cn.halfedgeNext[cn.halfedgeTwin[he]];
+        std::size_t kj = cn.halfedgeNext[ik];
+
+        gcs::Edge edge{mesh->edge(e)};
+        gc::Vector3 grad_li = cn.halfedgeVector(li, pos).normalize();
+        gc::Vector3 grad_ik =
+            cn.halfedgeVector(cn.halfedgeTwin[ik], pos).normalize();
+        double l_ik = cn.edgeLength(cn.halfedgeEdge[ik], pos);
+        forces.regularizationForce[i] +=
+            -regularizer.Kst *
+            (regularizer.computeLengthCrossRatio(*vpg, edge) -
+             regularizer.refLcrs[e]) /
+            regularizer.refLcrs[e] *
+            (cn.edgeLength(cn.halfedgeEdge[kj], pos) /
+             cn.edgeLength(cn.halfedgeEdge[jl], pos)) *
+            (grad_li * l_ik -
+             grad_ik * cn.edgeLength(cn.halfedgeEdge[li], pos)) /
+            l_ik / l_ik;
+      }
 
-        // Local area regularization
-        if (meshProcessor.meshRegularizer.Ksl != 0 && he.isInterior()) {
-          gcs::Halfedge base_he = he.next();
-          gc::Vector3 base_vec = vecFromHalfedge(base_he, *vpg);
-          gc::Vector3 localAreaGradient =
-              -gc::cross(base_vec, vpg->faceNormal(he.face()));
-          auto &referenceArea =
-              (v.isBoundary()
-                   ? meshProcessor.meshRegularizer
-                         .refFaceAreas[base_he.face().getIndex()]
-                   : meshProcessor.meshRegularizer.meanTargetFaceArea);
-          forces.regularizationForce[v] +=
-              -meshProcessor.meshRegularizer.Ksl * localAreaGradient *
-              (vpg->faceArea(base_he.face()) - referenceArea);
-        }
+      // Local area regularization
+      if (regularizer.Ksl != 0 && cn.isInterior(he)) {
+        std::size_t base_he = cn.halfedgeNext[he];
+        gc::Vector3 base_vec = cn.halfedgeVector(base_he, pos);
+        gc::Vector3 localAreaGradient =
+            -gc::cross(base_vec, cn.faceNormal(cn.halfedgeFace[he], pos));
+        forces.regularizationForce[i] +=
+            -regularizer.Ksl * localAreaGradient *
+            (cn.faceArea(cn.halfedgeFace[base_he], pos) -
+             regularizer.meanTargetFaceArea);
+      }
 
-        // local edge regularization
-        if (meshProcessor.meshRegularizer.Kse != 0) {
-          gc::Vector3 edgeGradient = -vecFromHalfedge(he, *vpg).normalize();
-          auto &referenceLength =
-              (v.isBoundary()
-                   ? meshProcessor.meshRegularizer.refEdgeLengths[e.getIndex()]
-                   : meshProcessor.meshRegularizer.meanTargetEdgeLength);
-          forces.regularizationForce[v] +=
-              -meshProcessor.meshRegularizer.Kse * edgeGradient *
-              (vpg->edgeLength(e) - referenceLength);
-        }
+      // local edge regularization
+      if (regularizer.Kse != 0) {
+        gc::Vector3 edgeGradient = -cn.halfedgeVector(he, pos).normalize();
+        forces.regularizationForce[i] +=
+            -regularizer.Kse * edgeGradient *
+            (cn.edgeLength(e, pos) - regularizer.meanTargetEdgeLength);
       }
     }
   }
@@ -337,9 +345,11 @@ bool System::growMesh() {
 }
 
 void System::mutateMesh(size_t nRepetition) {
+  // the marker accumulates over the repetitions, and follows the vertices
+  // through the compression of the mesh
+  mutationMarker.fill(false);
   for (size_t i = 0; i < nRepetition; ++i) {
     bool isGrown = false, isFlipped = false;
-    mutationMarker.fill(false);
 
     // vertex shift for regularization
     if (meshProcessor.meshMutator.shiftVertex) {
@@ -351,6 +361,9 @@ void System::mutateMesh(size_t nRepetition) {
         meshProcessor.meshMutator.isCollapseEdge) {
       isGrown = isGrown || growMesh();
     }
+    // the geodesic distance of the new vertices is interpolated
+    if (isGrown)
+      geodesicSolver.invalidateBoundedDistance();
 
     // linear edge flip for non-Delauney triangles
     if (meshProcessor.meshMutator.isEdgeFlip) {
@@ -379,7 +392,7 @@ System::smoothenMesh(double initStep, double target, size_t maxIteration) {
   size_t num_iter = 0;
   // compute bending forces
   vpg->refreshQuantities();
-  computeMechanicalForces();
+  computeVectorizedBendingForces();
   EigenVectorX3dr pastForceVec = toMatrix(forces.bendingForceVec);
   // initialize smoothingMask
   Eigen::Matrix<bool, Eigen::Dynamic, 1> smoothingMask =
@@ -401,11 +414,11 @@ System::smoothenMesh(double initStep, double target, size_t maxIteration) {
 
     // compute bending force if smoothingMask is true
     vpg->refreshQuantities();
-    forces.bendingForceVec.fill({0, 0, 0});
-    forces.bendingForce.raw().setZero();
+    computeVectorizedBendingForces();
     for (std::size_t i = 0; i < mesh->nVertices(); ++i) {
-      if (smoothingMask[i]) {
-        computeMechanicalForces(i);
+      if (!smoothingMask[i]) {
+        forces.bendingForceVec[i] = gc::Vector3{0, 0, 0};
+        forces.bendingForce[i] = 0;
       }
     }
     // compute norm of the bending force
@@ -493,6 +506,15 @@ void System::localSmoothing(const gcs::Halfedge &he, std::size_t num,
 }
 
 void System::globalUpdateAfterMutation() {
+  // rebuild the connectivity snapshot
+  connectivity.build(*mesh);
+  isSelfAvoidanceExclusionsCurrent = false;
+  isSelfAvoidanceVerletListCurrent = false;
+  isFaceBVHCurrent = false;
+  isCotanLaplacianPatternCurrent = false;
+  isGeodesicSolverCurrent = false;
+  isGlobalGeometryCurrent = false;
+
   // update the velocity
   velocity = forces.maskForce(velocity); // important: velocity interpolation
                                          // contaminate the zero velocity
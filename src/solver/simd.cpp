@@ -0,0 +1,491 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#include "mem3dg/solver/simd.h"
+
+#include <cmath>
+
+// x86 kernels are compiled with function level target attributes and
+// selected at runtime, hence no global -mavx flags are needed
+#if (defined(__GNUC__) || defined(__clang__)) &&                              \
+    (defined(__x86_64__) || defined(__i386__))
+#define MEM3DG_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace mem3dg {
+namespace solver {
+namespace simd {
+
+InstructionSet detectInstructionSet() {
+#ifdef MEM3DG_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return InstructionSet::AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return InstructionSet::AVX2;
+#endif
+  return InstructionSet::Scalar;
+}
+
+std::string toString(InstructionSet instructionSet) {
+  switch (instructionSet) {
+  case InstructionSet::AVX512:
+    return "AVX-512";
+  case InstructionSet::AVX2:
+    return "AVX2";
+  default:
+    return "scalar";
+  }
+}
+
+void BendingBatch::resize(std::size_t n) {
+  faceNormal.resize(n);
+  twinFaceNormal.resize(n);
+  edgeVec.resize(n);
+  nextEdgeVec.resize(n);
+  nextNextEdgeVec.resize(n);
+  twinNextNextEdgeVec.resize(n);
+  faceArea.resize(n);
+  dihedralAngle.resize(n);
+  tailCotan.resize(n);
+  twinTailCotan.resize(n);
+  oppositeCotan.resize(n);
+  nextOppositeCotan.resize(n);
+  twinOppositeCotan.resize(n);
+  schlafliWeight1.resize(n);
+  schlafliWeight2.resize(n);
+  areaGradWeight.resize(n);
+  gaussWeight.resize(n);
+  deviatoricGaussWeight.resize(n);
+  deviatoricAreaGradWeight.resize(n);
+  deviatoricSchlafliWeight1.resize(n);
+  deviatoricSchlafliWeight2.resize(n);
+  areaGrad.resize(n);
+  volumeVariation.resize(n);
+  gaussVec.resize(n);
+  schlafliVec1.resize(n);
+  schlafliVec2.resize(n);
+  dihedralOpposite.resize(n);
+  cornerAngleGradientSelf.resize(n);
+  cornerAngleGradientTip.resize(n);
+  cornerAngleGradientOpposite.resize(n);
+  schlafliTerm.resize(n);
+  areaGradTerm.resize(n);
+  gaussTerm.resize(n);
+  deviatoricMeanTerm.resize(n);
+}
+
+// Note: all kernels evaluate the same sequence of multiplications, divisions,
+// square roots and additions, and this file is built with -ffp-contract=off
+// (no fused multiply-add), so every lane reproduces the scalar kernel. The
+// weighting of the bending stage follows the sequence of
+// computeMechanicalForces, the geometry stage rounds the same formulas of
+// computeVariationalVectors differently in the last bits
+static void load3(const Vector3SoA &v, std::size_t k, double out[3]) {
+  for (int c = 0; c < 3; ++c)
+    out[c] = v.data(c)[k];
+}
+
+static void cross(const double a[3], const double b[3], double out[3]) {
+  out[0] = a[1] * b[2] - a[2] * b[1];
+  out[1] = a[2] * b[0] - a[0] * b[2];
+  out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static double dot(const double a[3], const double b[3]) {
+  return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static void computeGeometryBatchScalar(BendingBatch &b, std::size_t begin,
+                                       std::size_t end, bool isCornerAngle) {
+  for (std::size_t k = begin; k < end; ++k) {
+    double n[3], nt[3], eh[3], en[3], etnn[3], c1[3], c2[3];
+    load3(b.faceNormal, k, n);
+    load3(b.twinFaceNormal, k, nt);
+    load3(b.edgeVec, k, eh);
+    load3(b.nextEdgeVec, k, en);
+    load3(b.twinNextNextEdgeVec, k, etnn);
+    cross(n, en, c1);
+    cross(nt, etnn, c2);
+    double r = std::sqrt(dot(eh, eh));
+    double gaussScale = -(0.5 * b.dihedralAngle[k] / r);
+    double volumeScale = b.faceArea[k] / 3;
+    for (int c = 0; c < 3; ++c) {
+      double tail = b.tailCotan[k] * n[c] + b.twinTailCotan[k] * nt[c];
+      b.areaGrad.data(c)[k] = 0.25 * c1[c] + 0.25 * c2[c];
+      b.volumeVariation.data(c)[k] = n[c] * volumeScale;
+      b.gaussVec.data(c)[k] = gaussScale * eh[c];
+      b.schlafliVec1.data(c)[k] = tail;
+      b.schlafliVec2.data(c)[k] = tail + b.nextOppositeCotan[k] * n[c] +
+                                  b.twinOppositeCotan[k] * nt[c];
+      b.dihedralOpposite.data(c)[k] = b.oppositeCotan[k] * n[c];
+    }
+    if (!isCornerAngle)
+      continue;
+
+    // gradients of the corner angles at the tip and the opposite vertex
+    double enn[3], ck[3], cj[3];
+    load3(b.nextNextEdgeVec, k, enn);
+    cross(n, eh, ck);
+    cross(n, enn, cj);
+    double sk = -(1 / (std::sqrt(dot(ck, ck)) * r));
+    double sj = -(1 / (std::sqrt(dot(cj, cj)) * std::sqrt(dot(enn, enn))));
+    for (int c = 0; c < 3; ++c) {
+      double gk = sk * ck[c];
+      double gj = sj * cj[c];
+      b.cornerAngleGradientSelf.data(c)[k] = -(gk + gj);
+      b.cornerAngleGradientTip.data(c)[k] = gk;
+      b.cornerAngleGradientOpposite.data(c)[k] = gj;
+    }
+  }
+}
+
+static void computeBendingBatchScalar(BendingBatch &b, std::size_t begin,
+                                      std::size_t end) {
+  for (int c = 0; c < 3; ++c) {
+    const double *s1 = b.schlafliVec1.data(c);
+    const double *s2 = b.schlafliVec2.data(c);
+    const double *a = b.areaGrad.data(c);
+    const double *g = b.gaussVec.data(c);
+    double *schlafli = b.schlafliTerm.data(c);
+    double *area = b.areaGradTerm.data(c);
+    double *gauss = b.gaussTerm.data(c);
+    double *deviatoric = b.deviatoricMeanTerm.data(c);
+    for (std::size_t k = begin; k < end; ++k) {
+      schlafli[k] =
+          -(b.schlafliWeight1[k] * s1[k] + b.schlafliWeight2[k] * s2[k]);
+      area[k] = -(b.areaGradWeight[k] * a[k]);
+      gauss[k] = -(b.gaussWeight[k] * g[k]);
+      deviatoric[k] = -(b.deviatoricGaussWeight[k] * g[k] +
+                        b.deviatoricAreaGradWeight[k] * a[k] +
+                        (b.deviatoricSchlafliWeight1[k] * s1[k] +
+                         b.deviatoricSchlafliWeight2[k] * s2[k]));
+    }
+  }
+}
+
+#ifdef MEM3DG_SIMD_X86
+__attribute__((target("avx2"))) static inline __m256d negate(__m256d x) {
+  return _mm256_xor_pd(x, _mm256_set1_pd(-0.0));
+}
+
+__attribute__((target("avx2"))) static inline void
+load3(const Vector3SoA &v, std::size_t k, __m256d out[3]) {
+  for (int c = 0; c < 3; ++c)
+    out[c] = _mm256_loadu_pd(v.data(c) + k);
+}
+
+__attribute__((target("avx2"))) static inline void
+cross(const __m256d a[3], const __m256d b[3], __m256d out[3]) {
+  out[0] = _mm256_sub_pd(_mm256_mul_pd(a[1], b[2]), _mm256_mul_pd(a[2], b[1]));
+  out[1] = _mm256_sub_pd(_mm256_mul_pd(a[2], b[0]), _mm256_mul_pd(a[0], b[2]));
+  out[2] = _mm256_sub_pd(_mm256_mul_pd(a[0], b[1]), _mm256_mul_pd(a[1], b[0]));
+}
+
+__attribute__((target("avx2"))) static inline __m256d dot(const __m256d a[3],
+                                                          const __m256d b[3]) {
+  return _mm256_add_pd(
+      _mm256_add_pd(_mm256_mul_pd(a[0], b[0]), _mm256_mul_pd(a[1], b[1])),
+      _mm256_mul_pd(a[2], b[2]));
+}
+
+__attribute__((target("avx2"))) static void
+computeGeometryBatchAVX2(BendingBatch &b, std::size_t begin, std::size_t end,
+                         bool isCornerAngle) {
+  const __m256d quarter = _mm256_set1_pd(0.25);
+  const __m256d half = _mm256_set1_pd(0.5);
+  const __m256d three = _mm256_set1_pd(3);
+  const __m256d one = _mm256_set1_pd(1);
+  std::size_t k = begin;
+  for (; k + 4 <= end; k += 4) {
+    __m256d n[3], nt[3], eh[3], en[3], etnn[3], c1[3], c2[3];
+    load3(b.faceNormal, k, n);
+    load3(b.twinFaceNormal, k, nt);
+    load3(b.edgeVec, k, eh);
+    load3(b.nextEdgeVec, k, en);
+    load3(b.twinNextNextEdgeVec, k, etnn);
+    cross(n, en, c1);
+    cross(nt, etnn, c2);
+    __m256d r = _mm256_sqrt_pd(dot(eh, eh));
+    __m256d gaussScale = negate(_mm256_div_pd(
+        _mm256_mul_pd(half, _mm256_loadu_pd(b.dihedralAngle.data() + k)), r));
+    __m256d volumeScale =
+        _mm256_div_pd(_mm256_loadu_pd(b.faceArea.data() + k), three);
+    __m256d tailCotan = _mm256_loadu_pd(b.tailCotan.data() + k);
+    __m256d twinTailCotan = _mm256_loadu_pd(b.twinTailCotan.data() + k);
+    __m256d oppositeCotan = _mm256_loadu_pd(b.oppositeCotan.data() + k);
+    __m256d nextOppositeCotan =
+        _mm256_loadu_pd(b.nextOppositeCotan.data() + k);
+    __m256d twinOppositeCotan =
+        _mm256_loadu_pd(b.twinOppositeCotan.data() + k);
+    for (int c = 0; c < 3; ++c) {
+      __m256d tail = _mm256_add_pd(_mm256_mul_pd(tailCotan, n[c]),
+                                   _mm256_mul_pd(twinTailCotan, nt[c]));
+      _mm256_storeu_pd(b.areaGrad.data(c) + k,
+                       _mm256_add_pd(_mm256_mul_pd(quarter, c1[c]),
+                                     _mm256_mul_pd(quarter, c2[c])));
+      _mm256_storeu_pd(b.volumeVariation.data(c) + k,
+                       _mm256_mul_pd(n[c], volumeScale));
+      _mm256_storeu_pd(b.gaussVec.data(c) + k,
+                       _mm256_mul_pd(gaussScale, eh[c]));
+      _mm256_storeu_pd(b.schlafliVec1.data(c) + k, tail);
+      _mm256_storeu_pd(
+          b.schlafliVec2.data(c) + k,
+          _mm256_add_pd(
+              _mm256_add_pd(tail, _mm256_mul_pd(nextOppositeCotan, n[c])),
+              _mm256_mul_pd(twinOppositeCotan, nt[c])));
+      _mm256_storeu_pd(b.dihedralOpposite.data(c) + k,
+                       _mm256_mul_pd(oppositeCotan, n[c]));
+    }
+    if (!isCornerAngle)
+      continue;
+
+    __m256d enn[3], ck[3], cj[3];
+    load3(b.nextNextEdgeVec, k, enn);
+    cross(n, eh, ck);
+    cross(n, enn, cj);
+    __m256d sk = negate(_mm256_div_pd(
+        one, _mm256_mul_pd(_mm256_sqrt_pd(dot(ck, ck)), r)));
+    __m256d sj = negate(_mm256_div_pd(
+        one, _mm256_mul_pd(_mm256_sqrt_pd(dot(cj, cj)),
+                             _mm256_sqrt_pd(dot(enn, enn)))));
+    for (int c = 0; c < 3; ++c) {
+      __m256d gk = _mm256_mul_pd(sk, ck[c]);
+      __m256d gj = _mm256_mul_pd(sj, cj[c]);
+      _mm256_storeu_pd(b.cornerAngleGradientSelf.data(c) + k,
+                       negate(_mm256_add_pd(gk, gj)));
+      _mm256_storeu_pd(b.cornerAngleGradientTip.data(c) + k, gk);
+      _mm256_storeu_pd(b.cornerAngleGradientOpposite.data(c) + k, gj);
+    }
+  }
+  computeGeometryBatchScalar(b, k, end, isCornerAngle);
+}
+
+__attribute__((target("avx2"))) static void
+computeBendingBatchAVX2(BendingBatch &b, std::size_t begin, std::size_t end) {
+  const __m256d signMask = _mm256_set1_pd(-0.0);
+  std::size_t k = begin;
+  for (; k + 4 <= end; k += 4) {
+    __m256d w1 = _mm256_loadu_pd(b.schlafliWeight1.data() + k);
+    __m256d w2 = _mm256_loadu_pd(b.schlafliWeight2.data() + k);
+    __m256d wa = _mm256_loadu_pd(b.areaGradWeight.data() + k);
+    __m256d wg = _mm256_loadu_pd(b.gaussWeight.data() + k);
+    __m256d dg = _mm256_loadu_pd(b.deviatoricGaussWeight.data() + k);
+    __m256d da = _mm256_loadu_pd(b.deviatoricAreaGradWeight.data() + k);
+    __m256d d1 = _mm256_loadu_pd(b.deviatoricSchlafliWeight1.data() + k);
+    __m256d d2 = _mm256_loadu_pd(b.deviatoricSchlafliWeight2.data() + k);
+    for (int c = 0; c < 3; ++c) {
+      __m256d s1 = _mm256_loadu_pd(b.schlafliVec1.data(c) + k);
+      __m256d s2 = _mm256_loadu_pd(b.schlafliVec2.data(c) + k);
+      __m256d a = _mm256_loadu_pd(b.areaGrad.data(c) + k);
+      __m256d g = _mm256_loadu_pd(b.gaussVec.data(c) + k);
+      __m256d schlafli =
+          _mm256_add_pd(_mm256_mul_pd(w1, s1), _mm256_mul_pd(w2, s2));
+      __m256d deviatoric = _mm256_add_pd(
+          _mm256_add_pd(_mm256_mul_pd(dg, g), _mm256_mul_pd(da, a)),
+          _mm256_add_pd(_mm256_mul_pd(d1, s1), _mm256_mul_pd(d2, s2)));
+      _mm256_storeu_pd(b.schlafliTerm.data(c) + k,
+                       _mm256_xor_pd(schlafli, signMask));
+      _mm256_storeu_pd(b.areaGradTerm.data(c) + k,
+                       _mm256_xor_pd(_mm256_mul_pd(wa, a), signMask));
+      _mm256_storeu_pd(b.gaussTerm.data(c) + k,
+                       _mm256_xor_pd(_mm256_mul_pd(wg, g), signMask));
+      _mm256_storeu_pd(b.deviatoricMeanTerm.data(c) + k,
+                       _mm256_xor_pd(deviatoric, signMask));
+    }
+  }
+  computeBendingBatchScalar(b, k, end);
+}
+
+// exact negation by flipping the sign bit (_mm512_xor_pd requires AVX512DQ)
+__attribute__((target("avx512f"))) static inline __m512d negate(__m512d x) {
+  return _mm512_castsi512_pd(_mm512_xor_si512(
+      _mm512_castpd_si512(x), _mm512_castpd_si512(_mm512_set1_pd(-0.0))));
+}
+
+__attribute__((target("avx512f"))) static inline void
+load3(const Vector3SoA &v, std::size_t k, __m512d out[3]) {
+  for (int c = 0; c < 3; ++c)
+    out[c] = _mm512_loadu_pd(v.data(c) + k);
+}
+
+__attribute__((target("avx512f"))) static inline void
+cross(const __m512d a[3], const __m512d b[3], __m512d out[3]) {
+  out[0] = _mm512_sub_pd(_mm512_mul_pd(a[1], b[2]), _mm512_mul_pd(a[2], b[1]));
+  out[1] = _mm512_sub_pd(_mm512_mul_pd(a[2], b[0]), _mm512_mul_pd(a[0], b[2]));
+  out[2] = _mm512_sub_pd(_mm512_mul_pd(a[0], b[1]), _mm512_mul_pd(a[1], b[0]));
+}
+
+__attribute__((target("avx512f"))) static inline __m512d
+dot(const __m512d a[3], const __m512d b[3]) {
+  return _mm512_add_pd(
+      _mm512_add_pd(_mm512_mul_pd(a[0], b[0]), _mm512_mul_pd(a[1], b[1])),
+      _mm512_mul_pd(a[2], b[2]));
+}
+
+__attribute__((target("avx512f"))) static void
+computeGeometryBatchAVX512(BendingBatch &b, std::size_t begin,
+                           std::size_t end, bool isCornerAngle) {
+  const __m512d quarter = _mm512_set1_pd(0.25);
+  const __m512d half = _mm512_set1_pd(0.5);
+  const __m512d three = _mm512_set1_pd(3);
+  const __m512d one = _mm512_set1_pd(1);
+  std::size_t k = begin;
+  for (; k + 8 <= end; k += 8) {
+    __m512d n[3], nt[3], eh[3], en[3], etnn[3], c1[3], c2[3];
+    load3(b.faceNormal, k, n);
+    load3(b.twinFaceNormal, k, nt);
+    load3(b.edgeVec, k, eh);
+    load3(b.nextEdgeVec, k, en);
+    load3(b.twinNextNextEdgeVec, k, etnn);
+    cross(n, en, c1);
+    cross(nt, etnn, c2);
+    __m512d r = _mm512_sqrt_pd(dot(eh, eh));
+    __m512d gaussScale = negate(_mm512_div_pd(
+        _mm512_mul_pd(half, _mm512_loadu_pd(b.dihedralAngle.data() + k)), r));
+    __m512d volumeScale =
+        _mm512_div_pd(_mm512_loadu_pd(b.faceArea.data() + k), three);
+    __m512d tailCotan = _mm512_loadu_pd(b.tailCotan.data() + k);
+    __m512d twinTailCotan = _mm512_loadu_pd(b.twinTailCotan.data() + k);
+    __m512d oppositeCotan = _mm512_loadu_pd(b.oppositeCotan.data() + k);
+    __m512d nextOppositeCotan =
+        _mm512_loadu_pd(b.nextOppositeCotan.data() + k);
+    __m512d twinOppositeCotan =
+        _mm512_loadu_pd(b.twinOppositeCotan.data() + k);
+    for (int c = 0; c < 3; ++c) {
+      __m512d tail = _mm512_add_pd(_mm512_mul_pd(tailCotan, n[c]),
+                                   _mm512_mul_pd(twinTailCotan, nt[c]));
+      _mm512_storeu_pd(b.areaGrad.data(c) + k,
+                       _mm512_add_pd(_mm512_mul_pd(quarter, c1[c]),
+                                     _mm512_mul_pd(quarter, c2[c])));
+      _mm512_storeu_pd(b.volumeVariation.data(c) + k,
+                       _mm512_mul_pd(n[c], volumeScale));
+      _mm512_storeu_pd(b.gaussVec.data(c) + k,
+                       _mm512_mul_pd(gaussScale, eh[c]));
+      _mm512_storeu_pd(b.schlafliVec1.data(c) + k, tail);
+      _mm512_storeu_pd(
+          b.schlafliVec2.data(c) + k,
+          _mm512_add_pd(
+              _mm512_add_pd(tail, _mm512_mul_pd(nextOppositeCotan, n[c])),
+              _mm512_mul_pd(twinOppositeCotan, nt[c])));
+      _mm512_storeu_pd(b.dihedralOpposite.data(c) + k,
+                       _mm512_mul_pd(oppositeCotan, n[c]));
+    }
+    if (!isCornerAngle)
+      continue;
+
+    __m512d enn[3], ck[3], cj[3];
+    load3(b.nextNextEdgeVec, k, enn);
+    cross(n, eh, ck);
+    cross(n, enn, cj);
+    __m512d sk = negate(_mm512_div_pd(
+        one, _mm512_mul_pd(_mm512_sqrt_pd(dot(ck, ck)), r)));
+    __m512d sj = negate(_mm512_div_pd(
+        one, _mm512_mul_pd(_mm512_sqrt_pd(dot(cj, cj)),
+                             _mm512_sqrt_pd(dot(enn, enn)))));
+    for (int c = 0; c < 3; ++c) {
+      __m512d gk = _mm512_mul_pd(sk, ck[c]);
+      __m512d gj = _mm512_mul_pd(sj, cj[c]);
+      _mm512_storeu_pd(b.cornerAngleGradientSelf.data(c) + k,
+                       negate(_mm512_add_pd(gk, gj)));
+      _mm512_storeu_pd(b.cornerAngleGradientTip.data(c) + k, gk);
+      _mm512_storeu_pd(b.cornerAngleGradientOpposite.data(c) + k, gj);
+    }
+  }
+  computeGeometryBatchScalar(b, k, end, isCornerAngle);
+}
+
+__attribute__((target("avx512f"))) static void
+computeBendingBatchAVX512(BendingBatch &b, std::size_t begin,
+                          std::size_t end) {
+  std::size_t k = begin;
+  for (; k + 8 <= end; k += 8) {
+    __m512d w1 = _mm512_loadu_pd(b.schlafliWeight1.data() + k);
+    __m512d w2 = _mm512_loadu_pd(b.schlafliWeight2.data() + k);
+    __m512d wa = _mm512_loadu_pd(b.areaGradWeight.data() + k);
+    __m512d wg = _mm512_loadu_pd(b.gaussWeight.data() + k);
+    __m512d dg = _mm512_loadu_pd(b.deviatoricGaussWeight.data() + k);
+    __m512d da = _mm512_loadu_pd(b.deviatoricAreaGradWeight.data() + k);
+    __m512d d1 = _mm512_loadu_pd(b.deviatoricSchlafliWeight1.data() + k);
+    __m512d d2 = _mm512_loadu_pd(b.deviatoricSchlafliWeight2.data() + k);
+    for (int c = 0; c < 3; ++c) {
+      __m512d s1 = _mm512_loadu_pd(b.schlafliVec1.data(c) + k);
+      __m512d s2 = _mm512_loadu_pd(b.schlafliVec2.data(c) + k);
+      __m512d a = _mm512_loadu_pd(b.areaGrad.data(c) + k);
+      __m512d g = _mm512_loadu_pd(b.gaussVec.data(c) + k);
+      __m512d schlafli =
+          _mm512_add_pd(_mm512_mul_pd(w1, s1), _mm512_mul_pd(w2, s2));
+      __m512d deviatoric = _mm512_add_pd(
+          _mm512_add_pd(_mm512_mul_pd(dg, g), _mm512_mul_pd(da, a)),
+          _mm512_add_pd(_mm512_mul_pd(d1, s1), _mm512_mul_pd(d2, s2)));
+      _mm512_storeu_pd(b.schlafliTerm.data(c) + k, negate(schlafli));
+      _mm512_storeu_pd(b.areaGradTerm.data(c) + k,
+                       negate(_mm512_mul_pd(wa, a)));
+      _mm512_storeu_pd(b.gaussTerm.data(c) + k, negate(_mm512_mul_pd(wg, g)));
+      _mm512_storeu_pd(b.deviatoricMeanTerm.data(c) + k, negate(deviatoric));
+    }
+  }
+  computeBendingBatchScalar(b, k, end);
+}
+#endif
+
+void computeGeometryBatch(InstructionSet instructionSet, BendingBatch &batch,
+                          std::size_t begin, std::size_t end,
+                          bool isCornerAngle) {
+  // never run beyond what the CPU supports
+  static const InstructionSet supported = detectInstructionSet();
+  if (instructionSet > supported)
+    instructionSet = supported;
+
+  switch (instructionSet) {
+#ifdef MEM3DG_SIMD_X86
+  case InstructionSet::AVX512:
+    computeGeometryBatchAVX512(batch, begin, end, isCornerAngle);
+    break;
+  case InstructionSet::AVX2:
+    computeGeometryBatchAVX2(batch, begin, end, isCornerAngle);
+    break;
+#endif
+  default:
+    computeGeometryBatchScalar(batch, begin, end, isCornerAngle);
+    break;
+  }
+}
+
+void computeBendingBatch(InstructionSet instructionSet, BendingBatch &batch,
+                         std::size_t begin, std::size_t end) {
+  // never run beyond what the CPU supports
+  static const InstructionSet supported = detectInstructionSet();
+  if (instructionSet > supported)
+    instructionSet = supported;
+
+  switch (instructionSet) {
+#ifdef MEM3DG_SIMD_X86
+  case InstructionSet::AVX512:
+    computeBendingBatchAVX512(batch, begin, end);
+    break;
+  case InstructionSet::AVX2:
+    computeBendingBatchAVX2(batch, begin, end);
+    break;
+#endif
+  default:
+    computeBendingBatchScalar(batch, begin, end);
+    break;
+  }
+}
+
+} // namespace simd
+} // namespace solver
+} // namespace mem3dg
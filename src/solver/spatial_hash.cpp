@@ -0,0 +1,111 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+#include "mem3dg/solver/spatial_hash.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mem3dg/macros.h"
+
+namespace mem3dg {
+namespace solver {
+
+std::int64_t SpatialHash::cellIndex(double x) const {
+  return static_cast<std::int64_t>(std::floor(x / cellSize));
+}
+
+std::size_t SpatialHash::bucket(std::int64_t ix, std::int64_t iy,
+                                std::int64_t iz) const {
+  std::uint64_t key = static_cast<std::uint64_t>(ix) * 73856093ULL ^
+                      static_cast<std::uint64_t>(iy) * 19349663ULL ^
+                      static_cast<std::uint64_t>(iz) * 83492791ULL;
+  return key & (nBuckets - 1);
+}
+
+void SpatialHash::build(const gcs::VertexData<gc::Vector3> &positions,
+                        double size) {
+  if (!(size > 0))
+    mem3dg_runtime_error("SpatialHash: cell size has to be positive!");
+  cellSize = size;
+  const std::size_t n = positions.size();
+
+  // about two buckets per vertex
+  nBuckets = 1;
+  while (nBuckets < 2 * n)
+    nBuckets <<= 1;
+
+  vertexCells.resize(n);
+  std::vector<std::size_t> vertexBuckets(n);
+  bucketOffsets.assign(nBuckets + 1, 0);
+  for (std::size_t i = 0; i < n; ++i) {
+    const gc::Vector3 &x = positions[i];
+    if (!std::isfinite(x.x) || !std::isfinite(x.y) || !std::isfinite(x.z))
+      mem3dg_runtime_error("SpatialHash: vertex position is not finite!");
+    vertexCells[i] = {cellIndex(x.x), cellIndex(x.y), cellIndex(x.z)};
+    vertexBuckets[i] =
+        bucket(vertexCells[i][0], vertexCells[i][1], vertexCells[i][2]);
+    ++bucketOffsets[vertexBuckets[i] + 1];
+  }
+  for (std::size_t b = 0; b < nBuckets; ++b)
+    bucketOffsets[b + 1] += bucketOffsets[b];
+
+  // counting sort, vertices of a bucket stay in ascending order
+  bucketVertices.resize(n);
+  std::vector<std::size_t> fill(bucketOffsets.begin(), bucketOffsets.end() - 1);
+  for (std::size_t i = 0; i < n; ++i)
+    bucketVertices[fill[vertexBuckets[i]]++] = i;
+}
+
+void SpatialHash::findPairs(const gcs::VertexData<gc::Vector3> &positions,
+                            double cutoff, std::vector<Pair> &pairs) const {
+  if (cutoff > cellSize)
+    mem3dg_runtime_error("SpatialHash: cutoff is larger than the cell size!");
+  if (positions.size() != nVertices())
+    mem3dg_runtime_error("SpatialHash: positions do not match the build!");
+  const double cutoff2 = cutoff * cutoff;
+
+  pairs.clear();
+  std::vector<std::size_t> neighbors;
+  std::array<std::size_t, 27> visited;
+  for (std::size_t i = 0; i < nVertices(); ++i) {
+    const std::array<std::int64_t, 3> &c = vertexCells[i];
+    std::size_t nVisited = 0;
+    neighbors.clear();
+    for (std::int64_t dx = -1; dx <= 1; ++dx) {
+      for (std::int64_t dy = -1; dy <= 1; ++dy) {
+        for (std::int64_t dz = -1; dz <= 1; ++dz) {
+          // distinct cells may share a bucket, visit it only once
+          std::size_t b = bucket(c[0] + dx, c[1] + dy, c[2] + dz);
+          if (std::find(visited.begin(), visited.begin() + nVisited, b) !=
+              visited.begin() + nVisited)
+            continue;
+          visited[nVisited++] = b;
+          for (std::size_t k = bucketOffsets[b]; k < bucketOffsets[b + 1];
+               ++k) {
+            std::size_t j = bucketVertices[k];
+            if (j > i && gc::norm2(positions[j] - positions[i]) < cutoff2)
+              neighbors.push_back(j);
+          }
+        }
+      }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    for (std::size_t j : neighbors)
+      pairs.emplace_back(i, j);
+  }
+}
+
+} // namespace solver
+} // namespace mem3dg
@@ -45,6 +45,9 @@ void visualize(mem3dg::solver::System &f) {
   signal(SIGINT, mem3dg::signalHandler);
   // Initialize visualization variables
   float transparency = 1;
+  // the smoothing quantity needs the lumped mass matrix and cotan Laplacian
+  if (!f.isGeometryOperatorsCurrent)
+    f.refreshGeometry(true);
 
   // Set preference for polyscope
   initGui();
@@ -0,0 +1,326 @@
+// Membrane Dynamics in 3D using Discrete Differential Geometry (Mem3DG)
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+// Copyright (c) 2020:
+//     Laboratory for Computational Cellular Mechanobiology
+//     Cuncheng Zhu (cuzhu@eng.ucsd.edu)
+//     Christopher T. Lee (ctlee@ucsd.edu)
+//     Ravi Ramamoorthi (ravir@cs.ucsd.edu)
+//     Padmini Rangamani (prangamani@eng.ucsd.edu)
+//
+
+/**
+ * @file benchmark.cpp
+ * @brief Timing of the hot kernels of System on icosphere (closed) and
+ * hexagon (open) meshes. Usage:
+ * mem3dg_benchmark [minSubdivision] [maxSubdivision] [nRepeat]
+ * [maxGeometrySubdivision]
+ * The thread scaling of System::computeMechanicalForces() is timed from 1 up
+ * to the OpenMP default number of threads on the same icospheres, and its
+ * single thread throughput with the scalar against the vectorized bending
+ * kernels.
+ * The geometry refresh, i.e. vpg->refreshQuantities() against the fused sweep
+ * of System::computeGeometrySweep(), is timed on icospheres up to
+ * maxGeometrySubdivision (8 by default).
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "mem3dg/mem3dg"
+
+#include <geometrycentral/surface/manifold_surface_mesh.h>
+#include <geometrycentral/utilities/eigen_interop_helpers.h>
+
+namespace gc = ::geometrycentral;
+namespace gcs = ::geometrycentral::surface;
+
+using mem3dg::solver::Connectivity;
+using mem3dg::solver::MeshProcessor;
+using mem3dg::solver::Parameters;
+using mem3dg::solver::System;
+
+namespace {
+
+/**
+ * @brief Average wall time (s) of nRepeat evaluations of the callable
+ */
+template <typename F> double timeIt(F &&f, std::size_t nRepeat) {
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t n = 0; n < nRepeat; ++n) {
+    f();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / nRepeat;
+}
+
+Parameters benchmarkParameters() {
+  Parameters p;
+  p.bending.Kb = 8.22e-5;
+  p.bending.Kd = 8.22e-5;
+  p.tension.Ksg = 0.1;
+  p.tension.At = 4.0 * mem3dg::constants::PI;
+  p.osmotic.isPreferredVolume = true;
+  p.osmotic.Kv = 0.01;
+  p.osmotic.Vt = 4.0 / 3.0 * mem3dg::constants::PI * 0.7;
+  return p;
+}
+
+std::unique_ptr<System> makeIcosphereSystem(int nSub) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = mem3dg::getIcosphereMatrix(1, nSub);
+
+  Parameters p = benchmarkParameters();
+  MeshProcessor mp;
+  mp.meshRegularizer.Kst = 1e-6;
+  mp.meshRegularizer.Ksl = 1e-6;
+  mp.meshRegularizer.Kse = 1e-6;
+  mp.meshRegularizer.readReferenceData(topologyMatrix, vertexMatrix, 0);
+  return std::make_unique<System>(topologyMatrix, vertexMatrix, p, mp, 0, 0);
+}
+
+std::unique_ptr<System> makeHexagonSystem(int nSub) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> topologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> vertexMatrix;
+  std::tie(topologyMatrix, vertexMatrix) = mem3dg::getHexagonMatrix(1, nSub);
+
+  // open mesh: constant tension and pressure, pinned boundary
+  Parameters p = benchmarkParameters();
+  p.tension.isConstantSurfaceTension = true;
+  p.tension.Ksg = 1e-3;
+  p.osmotic.isPreferredVolume = false;
+  p.osmotic.isConstantOsmoticPressure = true;
+  p.osmotic.Vt = -1;
+  p.boundary.shapeBoundaryCondition = "pin";
+  MeshProcessor mp;
+  return std::make_unique<System>(topologyMatrix, vertexMatrix, p, mp, 0, 0);
+}
+
+// ==========================================================
+// ================   Connectivity traversal  ===============
+// ==========================================================
+std::size_t traverseHandles(gcs::ManifoldSurfaceMesh &mesh) {
+  std::size_t checksum = 0;
+  for (std::size_t i = 0; i < mesh.nVertices(); ++i) {
+    gcs::Vertex v{mesh.vertex(i)};
+    for (gcs::Halfedge he : v.outgoingHalfedges()) {
+      checksum += he.tipVertex().getIndex() +
+                  he.twin().next().next().edge().getIndex() +
+                  he.edge().isBoundary() + he.isInterior();
+    }
+  }
+  return checksum;
+}
+
+std::size_t traverseConnectivity(const Connectivity &cn) {
+  std::size_t checksum = 0;
+  for (std::size_t i = 0; i < cn.nVertices; ++i) {
+    for (std::size_t k = cn.outgoingOffsets[i]; k < cn.outgoingOffsets[i + 1];
+         ++k) {
+      std::size_t he = cn.outgoingHalfedges[k];
+      std::size_t he_twin_next_next =
+          cn.halfedgeNext[cn.halfedgeNext[cn.halfedgeTwin[he]]];
+      checksum += cn.halfedgeTip[he] + cn.halfedgeEdge[he_twin_next_next] +
+                  cn.isBoundaryEdge(he) + cn.isInterior(he);
+    }
+  }
+  return checksum;
+}
+
+void benchmarkConnectivity(System &f, std::size_t nRepeat) {
+  std::size_t handleChecksum = 0, connectivityChecksum = 0;
+  double handleTime = timeIt(
+      [&]() { handleChecksum = traverseHandles(*f.mesh); }, nRepeat);
+  double connectivityTime = timeIt(
+      [&]() { connectivityChecksum = traverseConnectivity(f.connectivity); },
+      nRepeat);
+  double buildTime =
+      timeIt([&]() { f.connectivity.build(*f.mesh); }, nRepeat);
+  double forceTime = timeIt([&]() { f.computeMechanicalForces(); }, nRepeat);
+  double regularizationTime =
+      timeIt([&]() { f.computeRegularizationForce(); }, nRepeat);
+
+  std::cout << "  traversal: handles " << handleTime << " s, connectivity "
+            << connectivityTime << " s"
+            << (handleChecksum == connectivityChecksum ? ""
+                                                       : " (MISMATCH!)")
+            << "\n  connectivity build: " << buildTime
+            << " s\n  computeMechanicalForces: " << forceTime
+            << " s\n  computeRegularizationForce: " << regularizationTime
+            << " s" << std::endl;
+}
+
+// ==========================================================
+// ================      Thread scaling       ===============
+// ==========================================================
+void benchmarkThreadScaling(System &f, std::size_t nRepeat) {
+  std::size_t nThreads = f.nThreads;
+  std::size_t maxThreads = mem3dg::getNumThreads(0);
+  f.nThreads = 1;
+  double serialTime = timeIt([&]() { f.computeMechanicalForces(); }, nRepeat);
+  std::cout << "  computeMechanicalForces: 1 thread " << serialTime << " s";
+  // doubling number of threads, ending at the default
+  for (std::size_t n = 2; n <= maxThreads; n *= 2) {
+    if (2 * n > maxThreads)
+      n = maxThreads;
+    f.nThreads = n;
+    double threadedTime =
+        timeIt([&]() { f.computeMechanicalForces(); }, nRepeat);
+    std::cout << ", " << n << " threads " << threadedTime << " s (x"
+              << serialTime / threadedTime << ")";
+  }
+  std::cout << std::endl;
+  f.nThreads = nThreads;
+}
+
+// ==========================================================
+// ================  Vectorized bending kernel  =============
+// ==========================================================
+void benchmarkVectorizedBending(System &f, std::size_t nRepeat) {
+  // single core throughput of computeMechanicalForces on the same (bending
+  // and deviatoric) terms of benchmarkParameters, where the scalar
+  // instruction set selects the scalar kernel
+  std::size_t nThreads = f.nThreads;
+  mem3dg::solver::simd::InstructionSet instructionSet = f.instructionSet;
+  f.nThreads = 1;
+  f.instructionSet = mem3dg::solver::simd::InstructionSet::Scalar;
+  double scalarTime = timeIt([&]() { f.computeMechanicalForces(); }, nRepeat);
+  std::cout << "  bending (1 thread): scalar kernel " << scalarTime << " s";
+  for (int is = 1;
+       is <= static_cast<int>(mem3dg::solver::simd::detectInstructionSet());
+       ++is) {
+    f.instructionSet = static_cast<mem3dg::solver::simd::InstructionSet>(is);
+    double vectorizedTime =
+        timeIt([&]() { f.computeMechanicalForces(); }, nRepeat);
+    std::cout << ", " << mem3dg::solver::simd::toString(f.instructionSet)
+              << " kernel " << vectorizedTime << " s (speedup "
+              << scalarTime / vectorizedTime << ")";
+  }
+  std::cout << std::endl;
+
+  // bending-only path of smoothenMesh, including the scalar batch fallback
+  std::cout << "  computeVectorizedBendingForces (1 thread):";
+  for (int is = 0;
+       is <= static_cast<int>(mem3dg::solver::simd::detectInstructionSet());
+       ++is) {
+    f.instructionSet = static_cast<mem3dg::solver::simd::InstructionSet>(is);
+    double vectorizedTime =
+        timeIt([&]() { f.computeVectorizedBendingForces(); }, nRepeat);
+    std::cout << " " << mem3dg::solver::simd::toString(f.instructionSet)
+              << " " << vectorizedTime << " s";
+  }
+  std::cout << std::endl;
+  f.nThreads = nThreads;
+  f.instructionSet = instructionSet;
+}
+
+// ==========================================================
+// ================  Closed mesh specialization  ============
+// ==========================================================
+void benchmarkClosedMeshKernels(System &f, std::size_t nRepeat) {
+  bool hasBoundary = f.connectivity.hasBoundary;
+  f.connectivity.hasBoundary = true;
+  double generalTime = timeIt([&]() { f.computeMechanicalForces(); }, nRepeat);
+  f.connectivity.hasBoundary = hasBoundary;
+  std::cout << "  general kernels: " << generalTime << " s";
+  if (!hasBoundary) {
+    double closedTime =
+        timeIt([&]() { f.computeMechanicalForces(); }, nRepeat);
+    std::cout << ", closed mesh kernels: " << closedTime << " s";
+  }
+  std::cout << std::endl;
+}
+
+// ==========================================================
+// ================     Face BVH refit        ===============
+// ==========================================================
+void benchmarkFaceBVH(System &f, std::size_t nRepeat) {
+  const mem3dg::solver::Connectivity &cn = f.connectivity;
+  mem3dg::solver::FaceBVH bvh;
+  double buildTime = timeIt(
+      [&]() { bvh.build(cn, f.vpg->inputVertexPositions, f.nThreads); },
+      nRepeat);
+  double serialRefitTime = timeIt(
+      [&]() { bvh.refit(cn, f.vpg->inputVertexPositions, 1); }, nRepeat);
+  double refitTime = timeIt(
+      [&]() { bvh.refit(cn, f.vpg->inputVertexPositions, f.nThreads); },
+      nRepeat);
+
+  // proximities within the mean edge length
+  Parameters::SelfAvoidance selfAvoidance = f.parameters.selfAvoidance;
+  f.parameters.selfAvoidance.cutoff = f.vpg->edgeLengths.raw().mean();
+  f.parameters.selfAvoidance.isFaceContact = true;
+  double contactTime = timeIt([&]() { f.findSelfContacts(); }, nRepeat);
+  f.parameters.selfAvoidance = selfAvoidance;
+
+  std::cout << "  face BVH: build " << buildTime << " s, refit (1 thread) "
+            << serialRefitTime << " s, refit " << refitTime
+            << " s, findSelfContacts " << contactTime << " s ("
+            << f.selfContacts.size() << " proximities)" << std::endl;
+}
+
+// ==========================================================
+// ================    Geometry refresh       ===============
+// ==========================================================
+void benchmarkGeometryRefresh(System &f, std::size_t nRepeat) {
+  bool isSelectiveRefresh = f.isSelectiveRefresh;
+  f.isSelectiveRefresh = false;
+  double fullTime = timeIt([&]() { f.refreshGeometry(); }, nRepeat);
+  f.isSelectiveRefresh = true;
+  f.refreshTimings.clear();
+  double selectiveTime = timeIt([&]() { f.refreshGeometry(); }, nRepeat);
+  f.isSelectiveRefresh = isSelectiveRefresh;
+
+  std::cout << "  geometry refresh: refreshQuantities " << fullTime
+            << " s, fused " << selectiveTime << " s (";
+  for (auto it = f.refreshTimings.begin(); it != f.refreshTimings.end();
+       ++it) {
+    std::cout << (it == f.refreshTimings.begin() ? "" : ", ") << it->first
+              << " " << it->second / nRepeat << " s";
+  }
+  std::cout << ")" << std::endl;
+  f.refreshGeometry(true);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  int minSub = argc > 1 ? std::atoi(argv[1]) : 3;
+  int maxSub = argc > 2 ? std::atoi(argv[2]) : 6;
+  std::size_t nRepeat = argc > 3 ? std::atoi(argv[3]) : 10;
+  int maxGeometrySub = argc > 4 ? std::atoi(argv[4]) : 8;
+
+  for (int nSub = minSub; nSub <= maxSub; ++nSub) {
+    std::unique_ptr<System> f = makeIcosphereSystem(nSub);
+    std::cout << "icosphere " << nSub << ": " << f->mesh->nVertices()
+              << " vertices, " << mem3dg::getNumThreads(f->nThreads)
+              << " threads" << std::endl;
+    benchmarkConnectivity(*f, nRepeat);
+    benchmarkThreadScaling(*f, nRepeat);
+    benchmarkVectorizedBending(*f, nRepeat);
+    benchmarkClosedMeshKernels(*f, nRepeat);
+    benchmarkFaceBVH(*f, nRepeat);
+  }
+  for (int nSub = minSub; nSub <= maxGeometrySub; ++nSub) {
+    std::unique_ptr<System> f = makeIcosphereSystem(nSub);
+    std::cout << "icosphere " << nSub << ": " << f->mesh->nVertices()
+              << " vertices, " << mem3dg::getNumThreads(f->nThreads)
+              << " threads" << std::endl;
+    benchmarkGeometryRefresh(*f, nRepeat);
+  }
+  for (int nSub = minSub; nSub <= maxSub; ++nSub) {
+    std::unique_ptr<System> f = makeHexagonSystem(nSub);
+    std::cout << "hexagon " << nSub << ": " << f->mesh->nVertices()
+              << " vertices" << std::endl;
+    benchmarkClosedMeshKernels(*f, nRepeat);
+  }
+  return 0;
+}
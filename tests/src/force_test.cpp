@@ -12,7 +12,13 @@
 //     Padmini Rangamani (prangamani@eng.ucsd.edu)
 //
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -100,6 +106,41 @@ protected:
     std::tie(topologyMatrix, vertexMatrix) =
         getCylinderMatrix(1, 10, 10, 5, 0.3);
   }
+
+  // parameters for closed meshes, which do not take boundary conditions
+  Parameters closedMeshParameters() {
+    Parameters closedP = p;
+    closedP.boundary.shapeBoundaryCondition = "none";
+    closedP.boundary.proteinBoundaryCondition = "none";
+    return closedP;
+  }
+
+  // all decomposed mechanical forces, stacked for comparison
+  static EigenVectorX3dr stackMechanicalForces(System &f) {
+    EigenVectorX3dr stacked(7 * f.mesh->nVertices(), 3);
+    stacked << toMatrix(f.forces.bendingForceVec),
+        toMatrix(f.forces.deviatoricForceVec),
+        toMatrix(f.forces.capillaryForceVec),
+        toMatrix(f.forces.osmoticForceVec),
+        toMatrix(f.forces.lineCapillaryForceVec),
+        toMatrix(f.forces.adsorptionForceVec),
+        toMatrix(f.forces.aggregationForceVec);
+    return stacked;
+  }
+
+  // set up the mutator to split the edges of the largest face pairs
+  static void splitLargestFaces(System &f) {
+    double maxPairArea = 0;
+    for (gcs::Edge e : f.mesh->edges()) {
+      gcs::Halfedge he = e.halfedge();
+      maxPairArea =
+          std::max(maxPairArea, f.vpg->faceAreas[he.face()] +
+                                    f.vpg->faceAreas[he.twin().face()]);
+    }
+    f.meshProcessor.meshMutator.isSplitEdge = true;
+    f.meshProcessor.meshMutator.splitLarge = true;
+    f.meshProcessor.meshMutator.targetFaceArea = maxPairArea / 4 * (1 - 1e-6);
+  }
 };
 
 /**
@@ -663,5 +704,885 @@ TEST_F(ForceTest, ConsistentForceEnergy) {
 
 #pragma endregion potential
 };
+
+/**
+ * @brief Test whether threaded computation of mechanical forces is bitwise
+ * identical to the serial computation on icospheres
+ */
+TEST_F(ForceTest, ThreadedMechanicalForcesTest) {
+  for (int nSub = 2; nSub <= 4; ++nSub) {
+    Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> icoTopologyMatrix;
+    Eigen::Matrix<double, Eigen::Dynamic, 3> icoVertexMatrix;
+    std::tie(icoTopologyMatrix, icoVertexMatrix) = getIcosphereMatrix(1, nSub);
+    Parameters closedP = closedMeshParameters();
+    mem3dg::solver::System f(icoTopologyMatrix, icoVertexMatrix, closedP, 0);
+
+    // serial computation
+    f.nThreads = 1;
+    f.computeMechanicalForces();
+    EigenVectorX3dr serialForces = stackMechanicalForces(f);
+
+    // threaded computation, with more threads than the usual test machine
+    // has cores to exercise the partitioning
+    f.nThreads = 4;
+    f.computeMechanicalForces();
+    EigenVectorX3dr threadedForces = stackMechanicalForces(f);
+
+    ASSERT_EQ(serialForces.rows(), threadedForces.rows());
+    for (Eigen::Index i = 0; i < serialForces.rows(); ++i) {
+      for (Eigen::Index j = 0; j < 3; ++j) {
+        EXPECT_EQ(serialForces(i, j), threadedForces(i, j))
+            << "threaded force differs from serial force at row " << i
+            << " on icosphere " << nSub;
+      }
+    }
+  }
+};
+
+TEST_F(ForceTest, VectorizedBendingForcesTest) {
+  // stack the fields written by the vectorized kernel for comparison
+  auto stackForces = [](System &f) {
+    EigenVectorX3dr stacked(5 * f.mesh->nVertices(), 3);
+    stacked << toMatrix(f.forces.bendingForceVec_areaGrad),
+        toMatrix(f.forces.bendingForceVec_gaussVec),
+        toMatrix(f.forces.bendingForceVec_schlafliVec),
+        toMatrix(f.forces.bendingForceVec),
+        toMatrix(f.forces.deviatoricForceVec_mean);
+    return stacked;
+  };
+
+  // closed and open (boundary) meshes
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> icoTopologyMatrix,
+      hexTopologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> icoVertexMatrix, hexVertexMatrix;
+  std::tie(icoTopologyMatrix, icoVertexMatrix) = getIcosphereMatrix(1, 4);
+  std::tie(hexTopologyMatrix, hexVertexMatrix) = getHexagonMatrix(1, 4);
+  Parameters closedP = closedMeshParameters();
+  std::vector<std::unique_ptr<System>> systems;
+  systems.push_back(
+      std::make_unique<System>(icoTopologyMatrix, icoVertexMatrix, closedP, 0));
+  systems.push_back(
+      std::make_unique<System>(hexTopologyMatrix, hexVertexMatrix, p, 0));
+
+  simd::InstructionSet widest = simd::detectInstructionSet();
+  for (auto &f : systems) {
+    // scalar kernel reference on one core
+    f->nThreads = 1;
+    f->instructionSet = simd::InstructionSet::Scalar;
+    f->computeMechanicalForces();
+    EigenVectorX3dr referenceForces = stackForces(*f);
+    EigenVectorX3dr referenceMechanicalForces = stackMechanicalForces(*f);
+    double referenceBending = f->forces.bendingForce.raw().norm();
+
+    for (int is = 0; is <= static_cast<int>(widest); ++is) {
+      f->instructionSet = static_cast<simd::InstructionSet>(is);
+      f->computeVectorizedBendingForces();
+      EigenVectorX3dr vectorizedForces = stackForces(*f);
+
+      EXPECT_TRUE(vectorizedForces.isApprox(referenceForces, 1e-12))
+          << simd::toString(f->instructionSet)
+          << " kernel differs from the scalar reference" << std::endl;
+      EXPECT_NEAR(f->forces.bendingForce.raw().norm(), referenceBending,
+                  1e-12 * referenceBending);
+
+      // the full force kernel dispatched through the vectorized precompute
+      f->computeMechanicalForces();
+      EXPECT_TRUE(
+          stackMechanicalForces(*f).isApprox(referenceMechanicalForces, 1e-12))
+          << simd::toString(f->instructionSet)
+          << " mechanical forces differ from the scalar kernel" << std::endl;
+    }
+  }
+};
+
+TEST_F(ForceTest, ForceTermSpecializationTest) {
+  std::size_t nSub = 0;
+  mem3dg::solver::System f(topologyMatrix, vertexMatrix, p, nSub);
+
+  // switch off every subset of the optional terms in the parameters
+  for (unsigned terms = 0; terms <= System::ALL_FORCE_TERMS; ++terms) {
+    f.parameters.bending.Kb = (terms & System::BENDING) ? p.bending.Kb : 0;
+    f.parameters.bending.Kd = (terms & System::DEVIATORIC) ? p.bending.Kd : 0;
+    f.parameters.bending.Kdc =
+        (terms & System::DEVIATORIC) ? p.bending.Kdc : 0;
+    f.parameters.adsorption.epsilon =
+        (terms & System::ADSORPTION) ? p.adsorption.epsilon : 0;
+    f.parameters.aggregation.chi =
+        (terms & System::AGGREGATION) ? p.aggregation.chi : 0;
+    f.parameters.dirichlet.eta =
+        (terms & System::LINE_TENSION) ? p.dirichlet.eta : 0;
+    f.updateConfigurations();
+    // the parameter change is picked up by updateConfigurations
+    EXPECT_EQ(f.activeForceTerms, terms);
+
+    // general kernel
+    f.activeForceTerms = System::ALL_FORCE_TERMS;
+    f.computeMechanicalForces();
+    EigenVectorX3dr generalForces = stackMechanicalForces(f);
+
+    // specialized kernel
+    f.updateActiveForceTerms();
+    EXPECT_EQ(f.activeForceTerms, terms);
+    f.computeMechanicalForces();
+    EigenVectorX3dr specializedForces = stackMechanicalForces(f);
+
+    EXPECT_TRUE((generalForces.array() == specializedForces.array()).all())
+        << "specialized kernel differs for force terms " << terms
+        << std::endl;
+  }
+};
+
+TEST_F(ForceTest, ClosedMeshSpecializationTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> icoTopologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> icoVertexMatrix;
+  std::tie(icoTopologyMatrix, icoVertexMatrix) = getIcosphereMatrix(1, 3);
+  Parameters closedP = closedMeshParameters();
+  mem3dg::solver::System f(icoTopologyMatrix, icoVertexMatrix, closedP, 0);
+  ASSERT_FALSE(f.connectivity.hasBoundary);
+
+  // general kernels, valid on any mesh
+  f.connectivity.hasBoundary = true;
+  f.computeMechanicalForces();
+  EigenVectorX3dr generalForces = stackMechanicalForces(f);
+
+  // boundary-free kernels
+  f.connectivity.hasBoundary = false;
+  f.computeMechanicalForces();
+  EigenVectorX3dr closedForces = stackMechanicalForces(f);
+
+  EXPECT_TRUE((generalForces.array() == closedForces.array()).all())
+      << "closed mesh kernel differs from the general kernel" << std::endl;
+};
+
+TEST_F(ForceTest, LeanForcesTest) {
+  std::size_t nSub = 0;
+  mem3dg::solver::System f(topologyMatrix, vertexMatrix, p, nSub);
+
+  // decomposed forces
+  f.isDecomposeForces = true;
+  f.computePhysicalForcing();
+  EigenVectorX3dr decomposedForceVec = toMatrix(f.forces.mechanicalForceVec);
+  EigenVectorX3dr bendingForceVec = toMatrix(f.forces.bendingForceVec);
+  EigenVectorX3dr capillaryForceVec = toMatrix(f.forces.capillaryForceVec);
+  EigenVectorX1d bendingForce = toMatrix(f.forces.bendingForce);
+
+  // lean mode only updates the total force
+  f.isDecomposeForces = false;
+  f.forces.bendingForceVec.fill({0, 0, 0});
+  f.computePhysicalForcing();
+  EigenVectorX3dr leanForceVec = toMatrix(f.forces.mechanicalForceVec);
+  EXPECT_TRUE((decomposedForceVec.array() == leanForceVec.array()).all());
+  EXPECT_EQ(toMatrix(f.forces.bendingForceVec).norm(), 0);
+
+  // components on request
+  f.computeDecomposedForces();
+  EXPECT_FALSE(f.isDecomposeForces);
+  EXPECT_TRUE(
+      (toMatrix(f.forces.bendingForceVec).array() == bendingForceVec.array())
+          .all());
+  EXPECT_TRUE((toMatrix(f.forces.capillaryForceVec).array() ==
+               capillaryForceVec.array())
+                  .all());
+  EXPECT_TRUE(
+      (toMatrix(f.forces.bendingForce).array() == bendingForce.array()).all());
+  EXPECT_TRUE((toMatrix(f.forces.mechanicalForceVec).array() ==
+               leanForceVec.array())
+                  .all());
+};
+
+TEST_F(ForceTest, FusedForceEnergyTest) {
+  std::size_t nSub = 0;
+  mem3dg::solver::System f(topologyMatrix, vertexMatrix, p, nSub);
+
+  // separate sweeps
+  f.computePhysicalForcing();
+  f.computeTotalEnergy();
+  EigenVectorX3dr forceVec = toMatrix(f.forces.mechanicalForceVec);
+  EigenVectorX1d chemicalPotential = toMatrix(f.forces.chemicalPotential);
+  Energy energy = f.energy;
+
+  // fused sweep, the forces are untouched by the energy accumulation
+  f.energy = Energy({f.time, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0});
+  std::tuple<const Forces &, const Energy &> fused =
+      f.computePhysicalForcingAndEnergy();
+  const Forces &fusedForces = std::get<0>(fused);
+  const Energy &fusedEnergy = std::get<1>(fused);
+  EXPECT_EQ(&fusedForces, &f.forces);
+  EXPECT_EQ(&fusedEnergy, &f.energy);
+  EXPECT_TRUE(
+      (toMatrix(f.forces.mechanicalForceVec).array() == forceVec.array())
+          .all());
+  EXPECT_TRUE((toMatrix(f.forces.chemicalPotential).array() ==
+               chemicalPotential.array())
+                  .all());
+
+  // energies only differ by the summation order
+  auto expectNear = [](double expected, double actual) {
+    EXPECT_NEAR(expected, actual, 1e-12 * std::max(1.0, std::abs(expected)));
+  };
+  expectNear(energy.bendingEnergy, fusedEnergy.bendingEnergy);
+  expectNear(energy.deviatoricEnergy, fusedEnergy.deviatoricEnergy);
+  expectNear(energy.surfaceEnergy, fusedEnergy.surfaceEnergy);
+  expectNear(energy.pressureEnergy, fusedEnergy.pressureEnergy);
+  expectNear(energy.adsorptionEnergy, fusedEnergy.adsorptionEnergy);
+  expectNear(energy.aggregationEnergy, fusedEnergy.aggregationEnergy);
+  expectNear(energy.dirichletEnergy, fusedEnergy.dirichletEnergy);
+  expectNear(energy.selfAvoidancePenalty, fusedEnergy.selfAvoidancePenalty);
+  expectNear(energy.proteinInteriorPenalty,
+             fusedEnergy.proteinInteriorPenalty);
+  expectNear(energy.potentialEnergy, fusedEnergy.potentialEnergy);
+  expectNear(energy.totalEnergy, fusedEnergy.totalEnergy);
+  EXPECT_NE(fusedEnergy.dirichletEnergy, 0);
+};
+
+TEST_F(ForceTest, IncrementalMutationUpdateTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> icoTopologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> icoVertexMatrix;
+  std::tie(icoTopologyMatrix, icoVertexMatrix) = getIcosphereMatrix(1, 3);
+  Parameters closedP = closedMeshParameters();
+  closedP.variation.isProteinVariation = false;
+
+  // with several repetitions, the vertices of every pass are marked
+  for (int config = 0; config < 4; ++config) {
+    bool isDecomposeForces = (config % 2 == 0);
+    std::size_t nRepetition = 1 + config / 2;
+    mem3dg::solver::System incremental(icoTopologyMatrix, icoVertexMatrix,
+                                       closedP, 0);
+    mem3dg::solver::System global(icoTopologyMatrix, icoVertexMatrix, closedP,
+                                  0);
+
+    // split the edges of the largest face pairs
+    for (mem3dg::solver::System *f : {&incremental, &global}) {
+      f->isDecomposeForces = isDecomposeForces;
+      splitLargestFaces(*f);
+      f->computePhysicalForcing();
+      f->mutateMesh(nRepetition);
+    }
+    ASSERT_GT(incremental.mesh->nVertices(),
+              static_cast<std::size_t>(icoVertexMatrix.rows()));
+
+    EXPECT_TRUE(incremental.updateMutatedConfigurations());
+    EXPECT_FALSE(incremental.isGeometryOperatorsCurrent);
+    EXPECT_EQ(incremental.isMutatedForcesLocal, isDecomposeForces);
+    incremental.computePhysicalForcing();
+    global.updateConfigurations(false);
+    global.computePhysicalForcing();
+
+    auto expectApprox = [](const EigenVectorX3dr &actual,
+                           const EigenVectorX3dr &expected) {
+      EXPECT_LE((actual - expected).norm(), 1e-10 * expected.norm());
+    };
+    expectApprox(toMatrix(incremental.forces.mechanicalForceVec),
+                 toMatrix(global.forces.mechanicalForceVec));
+    expectApprox(toMatrix(incremental.vpg->vertexNormals),
+                 toMatrix(global.vpg->vertexNormals));
+    EXPECT_TRUE(incremental.vpg->vertexMeanCurvatures.raw().isApprox(
+        global.vpg->vertexMeanCurvatures.raw(), 1e-10));
+    EXPECT_TRUE(incremental.vpg->vertexGaussianCurvatures.raw().isApprox(
+        global.vpg->vertexGaussianCurvatures.raw(), 1e-10));
+    EXPECT_NEAR(incremental.surfaceArea, global.surfaceArea, 1e-12);
+    EXPECT_NEAR(incremental.volume, global.volume, 1e-12);
+  }
+};
+
+TEST_F(ForceTest, IncrementalMutationRescaleTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> icoTopologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> icoVertexMatrix;
+  std::tie(icoTopologyMatrix, icoVertexMatrix) = getIcosphereMatrix(1, 3);
+  Parameters closedP = closedMeshParameters();
+  closedP.variation.isProteinVariation = false;
+  closedP.tension.isConstantSurfaceTension = false;
+  closedP.tension.At = 0.9 * 4 * constants::PI;
+  closedP.osmotic.isConstantOsmoticPressure = false;
+  closedP.osmotic.isPreferredVolume = true;
+  closedP.osmotic.Vt = 0.7 * 4.0 / 3.0 * constants::PI;
+  mem3dg::solver::System incremental(icoTopologyMatrix, icoVertexMatrix,
+                                     closedP, 0);
+  mem3dg::solver::System global(icoTopologyMatrix, icoVertexMatrix, closedP,
+                                0);
+  double surfaceTension = 0, osmoticPressure = 0;
+  for (mem3dg::solver::System *f : {&incremental, &global}) {
+    splitLargestFaces(*f);
+    f->computePhysicalForcing();
+    surfaceTension = f->forces.surfaceTension;
+    osmoticPressure = f->forces.osmoticPressure;
+    f->mutateMesh();
+    // change of the preferred area and volume along with the mutation
+    f->parameters.tension.At *= 1.01;
+    f->parameters.osmotic.Vt *= 1.01;
+  }
+  ASSERT_GT(incremental.mesh->nVertices(),
+            static_cast<std::size_t>(icoVertexMatrix.rows()));
+
+  // the capillary and osmotic forces away from the mutation are rescaled
+  EXPECT_TRUE(incremental.updateMutatedConfigurations());
+  EXPECT_TRUE(incremental.isMutatedForcesLocal);
+  EXPECT_NE(incremental.forces.surfaceTension, surfaceTension);
+  EXPECT_NE(incremental.forces.osmoticPressure, osmoticPressure);
+  incremental.computePhysicalForcing();
+  global.updateConfigurations(false);
+  global.computePhysicalForcing();
+  EXPECT_DOUBLE_EQ(incremental.forces.surfaceTension,
+                   global.forces.surfaceTension);
+  EXPECT_DOUBLE_EQ(incremental.forces.osmoticPressure,
+                   global.forces.osmoticPressure);
+
+  auto expectApprox = [](const EigenVectorX3dr &actual,
+                         const EigenVectorX3dr &expected) {
+    EXPECT_LE((actual - expected).norm(), 1e-10 * expected.norm());
+  };
+  expectApprox(toMatrix(incremental.forces.capillaryForceVec),
+               toMatrix(global.forces.capillaryForceVec));
+  expectApprox(toMatrix(incremental.forces.osmoticForceVec),
+               toMatrix(global.forces.osmoticForceVec));
+  expectApprox(toMatrix(incremental.forces.mechanicalForceVec),
+               toMatrix(global.forces.mechanicalForceVec));
+  EXPECT_TRUE(incremental.forces.capillaryForce.raw().isApprox(
+      global.forces.capillaryForce.raw(), 1e-10));
+  EXPECT_TRUE(incremental.forces.osmoticForce.raw().isApprox(
+      global.forces.osmoticForce.raw(), 1e-10));
+}
+
+TEST_F(ForceTest, DeterministicReductionTest) {
+  // several reduction blocks
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> icoTopologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> icoVertexMatrix;
+  std::tie(icoTopologyMatrix, icoVertexMatrix) = getIcosphereMatrix(1, 5);
+  Parameters closedP = closedMeshParameters();
+  closedP.selfAvoidance.mu = 0;
+  mem3dg::solver::System f(icoTopologyMatrix, icoVertexMatrix, closedP, 0);
+  ASSERT_GT(f.mesh->nVertices(), 2 * REDUCTION_BLOCK_SIZE);
+  f.velocity.fill({0.1, -0.2, 0.3});
+
+  auto evaluate = [&f](std::size_t nThreads) {
+    f.nThreads = nThreads;
+    f.computePhysicalForcing();
+    f.computeTotalEnergy();
+    return std::make_pair(f.energy, f.mechErrorNorm);
+  };
+  Energy serialEnergy, threadedEnergy;
+  double serialNorm, threadedNorm;
+  std::tie(serialEnergy, serialNorm) = evaluate(1);
+  std::tie(threadedEnergy, threadedNorm) = evaluate(3);
+
+  EXPECT_EQ(serialEnergy.bendingEnergy, threadedEnergy.bendingEnergy);
+  EXPECT_EQ(serialEnergy.deviatoricEnergy, threadedEnergy.deviatoricEnergy);
+  EXPECT_EQ(serialEnergy.adsorptionEnergy, threadedEnergy.adsorptionEnergy);
+  EXPECT_EQ(serialEnergy.aggregationEnergy, threadedEnergy.aggregationEnergy);
+  EXPECT_EQ(serialEnergy.dirichletEnergy, threadedEnergy.dirichletEnergy);
+  EXPECT_EQ(serialEnergy.proteinInteriorPenalty,
+            threadedEnergy.proteinInteriorPenalty);
+  EXPECT_EQ(serialEnergy.kineticEnergy, threadedEnergy.kineticEnergy);
+  EXPECT_EQ(serialEnergy.totalEnergy, threadedEnergy.totalEnergy);
+  EXPECT_EQ(serialNorm, threadedNorm);
+
+  // accurate to the plain sums
+  EXPECT_NEAR(serialEnergy.kineticEnergy,
+              0.5 * toMatrix(f.velocity).squaredNorm(),
+              1e-12 * serialEnergy.kineticEnergy);
+  EXPECT_NEAR(serialNorm, toMatrix(f.forces.mechanicalForceVec).norm(),
+              1e-12 * serialNorm);
+};
+
+TEST_F(ForceTest, SpatialHashSelfAvoidanceTest) {
+  mem3dg::solver::System f(topologyMatrix, vertexMatrix, p, 0);
+  // contraction, so that pairs approach each other
+  toMatrix(f.velocity) = -0.1 * toMatrix(f.vpg->inputVertexPositions);
+
+  // cutoff beyond the mesh size reproduces the double loop
+  auto evaluate = [&f](double cutoff) {
+    f.parameters.selfAvoidance.cutoff = cutoff;
+    f.computeSelfAvoidanceForce();
+    f.computeSelfAvoidanceEnergy();
+    EigenVectorX3dr force = toMatrix(f.forces.selfAvoidanceForceVec);
+    return std::make_tuple(force, f.energy.selfAvoidancePenalty,
+                           f.projectedCollideTime);
+  };
+  EigenVectorX3dr bruteForce, hashedForce;
+  double bruteEnergy, hashedEnergy, bruteCollideTime, hashedCollideTime;
+  std::tie(bruteForce, bruteEnergy, bruteCollideTime) = evaluate(0);
+  std::tie(hashedForce, hashedEnergy, hashedCollideTime) = evaluate(100);
+  EXPECT_GT(bruteCollideTime, 0);
+  EXPECT_TRUE(bruteForce == hashedForce);
+  EXPECT_EQ(bruteEnergy, hashedEnergy);
+  EXPECT_EQ(bruteCollideTime, hashedCollideTime);
+
+  // finite cutoff keeps exactly the non-neighboring pairs within the cutoff
+  const double cutoff = 1.5;
+  std::tie(hashedForce, hashedEnergy, hashedCollideTime) = evaluate(cutoff);
+  std::vector<SpatialHash::Pair> pairs;
+  double energy = 0;
+  for (std::size_t i = 0; i < f.mesh->nVertices(); ++i) {
+    gc::VertexData<bool> neighborList(*f.mesh, false);
+    f.meshProcessor.meshMutator.markVertices(neighborList, f.mesh->vertex(i),
+                                             p.selfAvoidance.n);
+    for (std::size_t j = i + 1; j < f.mesh->nVertices(); ++j) {
+      double distance = gc::norm(f.vpg->inputVertexPositions[j] -
+                                 f.vpg->inputVertexPositions[i]);
+      if (!neighborList[j] && distance < cutoff) {
+        pairs.emplace_back(i, j);
+        energy += p.selfAvoidance.mu * f.proteinDensity[i] *
+                  f.proteinDensity[j] / (distance - p.selfAvoidance.d);
+      }
+    }
+  }
+  EXPECT_GT(pairs.size(), 0u);
+  EXPECT_TRUE(f.selfAvoidancePairs == pairs);
+  EXPECT_NEAR(hashedEnergy, energy, 1e-12 * energy);
+  EXPECT_LE(hashedEnergy, bruteEnergy);
+};
+
+TEST_F(ForceTest, SelfAvoidanceExclusionTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> icoTopologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> icoVertexMatrix;
+  std::tie(icoTopologyMatrix, icoVertexMatrix) = getIcosphereMatrix(1, 2);
+  Parameters closedP = closedMeshParameters();
+  closedP.variation.isProteinVariation = false;
+  closedP.selfAvoidance.n = 2;
+  mem3dg::solver::System f(icoTopologyMatrix, icoVertexMatrix, closedP, 0);
+
+  // cached lists agree with the marked neighborhood layers
+  auto expectExclusions = [&f]() {
+    f.updateConfigurations(false);
+    f.computeSelfAvoidanceEnergy();
+    ASSERT_EQ(f.selfAvoidanceExclusionOffsets.size(),
+              f.mesh->nVertices() + 1);
+    for (std::size_t i = 0; i < f.mesh->nVertices(); ++i) {
+      gc::VertexData<bool> neighborList(*f.mesh, false);
+      f.meshProcessor.meshMutator.markVertices(
+          neighborList, f.mesh->vertex(i), f.parameters.selfAvoidance.n);
+      std::vector<std::size_t> expected;
+      for (std::size_t j = i + 1; j < f.mesh->nVertices(); ++j) {
+        if (neighborList[j])
+          expected.push_back(j);
+      }
+      std::vector<std::size_t> cached(
+          f.selfAvoidanceExclusions.begin() +
+              f.selfAvoidanceExclusionOffsets[i],
+          f.selfAvoidanceExclusions.begin() +
+              f.selfAvoidanceExclusionOffsets[i + 1]);
+      EXPECT_EQ(cached, expected) << "vertex " << i;
+    }
+  };
+  expectExclusions();
+
+  // rebuilt for fewer layers
+  f.parameters.selfAvoidance.n = 1;
+  expectExclusions();
+
+  // rebuilt after mutation
+  splitLargestFaces(f);
+  f.mutateMesh();
+  ASSERT_GT(f.mesh->nVertices(),
+            static_cast<std::size_t>(icoVertexMatrix.rows()));
+  expectExclusions();
+};
+
+TEST_F(ForceTest, VerletListSelfAvoidanceTest) {
+  Parameters verletP = p;
+  verletP.selfAvoidance.cutoff = 1.5;
+  mem3dg::solver::System hashed(topologyMatrix, vertexMatrix, verletP, 0);
+  verletP.selfAvoidance.skin = 0.4;
+  mem3dg::solver::System verlet(topologyMatrix, vertexMatrix, verletP, 0);
+
+  // every vertex moves by 3/8 of the skin per step
+  const std::size_t nStep = 10;
+  const std::size_t hashedCount = hashed.selfAvoidanceRebuildCount;
+  const std::size_t verletCount = verlet.selfAvoidanceRebuildCount;
+  EigenVectorX3dr displacement = 0.15 * Eigen::MatrixXd::Random(
+                                           verlet.mesh->nVertices(), 3)
+                                           .rowwise()
+                                           .normalized();
+  for (std::size_t n = 0; n < nStep; ++n) {
+    for (mem3dg::solver::System *f : {&hashed, &verlet}) {
+      toMatrix(f->vpg->inputVertexPositions) += displacement;
+      f->computeSelfAvoidanceForce();
+      f->computeSelfAvoidanceEnergy();
+    }
+    EXPECT_TRUE(verlet.selfAvoidancePairs == hashed.selfAvoidancePairs);
+    EXPECT_TRUE(toMatrix(verlet.forces.selfAvoidanceForceVec) ==
+                toMatrix(hashed.forces.selfAvoidanceForceVec));
+    EXPECT_EQ(verlet.energy.selfAvoidancePenalty,
+              hashed.energy.selfAvoidancePenalty);
+    EXPECT_EQ(verlet.projectedCollideTime, hashed.projectedCollideTime);
+  }
+
+  // rebuilt every other step, versus at every new configuration
+  EXPECT_EQ(hashed.selfAvoidanceRebuildCount - hashedCount, nStep);
+  EXPECT_EQ(verlet.selfAvoidanceRebuildCount - verletCount, nStep / 2);
+};
+
+TEST_F(ForceTest, TreeCodeSelfAvoidanceTest) {
+  mem3dg::solver::System f(topologyMatrix, vertexMatrix, p, 0);
+  toMatrix(f.velocity) = -0.1 * toMatrix(f.vpg->inputVertexPositions);
+
+  auto evaluate = [&f](double theta) {
+    f.parameters.selfAvoidance.theta = theta;
+    f.computeSelfAvoidanceForce();
+    f.computeSelfAvoidanceEnergy();
+    EigenVectorX3dr force = toMatrix(f.forces.selfAvoidanceForceVec);
+    return std::make_tuple(force, f.energy.selfAvoidancePenalty,
+                           f.projectedCollideTime);
+  };
+  EigenVectorX3dr exactForce, treeForce;
+  double exactEnergy, treeEnergy, exactCollideTime, treeCollideTime;
+  std::tie(exactForce, exactEnergy, exactCollideTime) = evaluate(0);
+
+  // opening no node reproduces the double loop
+  std::tie(treeForce, treeEnergy, treeCollideTime) = evaluate(1e-6);
+  EXPECT_LE((treeForce - exactForce).norm(), 1e-12 * exactForce.norm());
+  EXPECT_NEAR(treeEnergy, exactEnergy, 1e-12 * exactEnergy);
+  EXPECT_DOUBLE_EQ(treeCollideTime, exactCollideTime);
+
+  // error of the monopole approximation, second order in theta
+  for (double theta : {0.25, 0.5}) {
+    std::tie(treeForce, treeEnergy, treeCollideTime) = evaluate(theta);
+    double forceError = (treeForce - exactForce).norm() / exactForce.norm();
+    double energyError = std::abs(treeEnergy - exactEnergy) / exactEnergy;
+    std::cout << "tree code theta = " << theta
+              << ": relative force error = " << forceError
+              << ", relative energy error = " << energyError << std::endl;
+    EXPECT_LT(forceError, 0.1 * theta * theta);
+    EXPECT_LT(energyError, 0.01 * theta * theta);
+  }
+
+  // a wide opening angle still opens the nodes near each vertex, so no
+  // excluded neighbor or pair closer than d enters a monopole
+  std::tie(treeForce, treeEnergy, treeCollideTime) = evaluate(10);
+  EXPECT_TRUE(std::isfinite(treeEnergy));
+  EXPECT_GT(treeEnergy, 0);
+  EXPECT_TRUE(treeForce.allFinite());
+  EXPECT_LT(std::abs(treeEnergy - exactEnergy), exactEnergy);
+};
+
+TEST_F(ForceTest, FaceContactSelfAvoidanceTest) {
+  // closest primitives
+  std::array<double, 3> b;
+  gc::Vector3 q = closestPointOnTriangle({0.2, 0.2, 1}, {0, 0, 0}, {1, 0, 0},
+                                         {0, 1, 0}, b);
+  EXPECT_NEAR(gc::norm(q - gc::Vector3{0.2, 0.2, 0}), 0, 1e-15);
+  EXPECT_NEAR(b[0], 0.6, 1e-15);
+  q = closestPointOnTriangle({2, 2, 1}, {0, 0, 0}, {1, 0, 0}, {0, 1, 0}, b);
+  EXPECT_NEAR(gc::norm(q - gc::Vector3{0.5, 0.5, 0}), 0, 1e-15);
+  double s, t;
+  closestPointsOnSegments({0, 0, 0}, {1, 0, 0}, {2, -1, 1}, {2, 1, 1}, s, t);
+  EXPECT_EQ(s, 1);
+  EXPECT_NEAR(t, 0.5, 1e-15);
+
+  Parameters contactP = p;
+  contactP.selfAvoidance.cutoff = 1;
+  contactP.selfAvoidance.isFaceContact = true;
+  mem3dg::solver::System f(topologyMatrix, vertexMatrix, contactP, 0);
+  f.computeSelfAvoidanceForce();
+  f.computeSelfAvoidanceEnergy();
+
+  // all vertex-face proximities within the cutoff, once per pair of closest
+  // features
+  std::set<std::array<std::size_t, 6>> vertexFace;
+  for (std::size_t i = 0; i < f.mesh->nVertices(); ++i) {
+    for (std::size_t face = 0; face < f.mesh->nFaces(); ++face) {
+      std::array<std::size_t, 3> v =
+          FaceBVH::faceVertices(f.connectivity, face);
+      if (f.isSelfAvoidanceExcluded(i, v[0]) ||
+          f.isSelfAvoidanceExcluded(i, v[1]) ||
+          f.isSelfAvoidanceExcluded(i, v[2]))
+        continue;
+      const gcs::VertexData<gc::Vector3> &x = f.vpg->inputVertexPositions;
+      if (gc::norm(x[i] - closestPointOnTriangle(x[i], x[v[0]], x[v[1]],
+                                                 x[v[2]], b)) < 1)
+        vertexFace.insert(closestFeatures(
+            {{i, v[0], v[1], v[2]}, {1, -b[0], -b[1], -b[2]}, {0, 0, 0}, 0}));
+    }
+  }
+  // the two vertices of an edge are neighbors, the vertex and the face are not
+  std::size_t nFound =
+      std::count_if(f.selfContacts.begin(), f.selfContacts.end(),
+                    [&f](const Proximity &contact) {
+                      return !f.isSelfAvoidanceExcluded(contact.vertices[0],
+                                                        contact.vertices[1]);
+                    });
+  EXPECT_GT(vertexFace.size(), 0u);
+  EXPECT_GT(f.selfContacts.size(), nFound);
+  EXPECT_EQ(nFound, vertexFace.size());
+
+  // no feature pair is counted twice
+  std::set<std::array<std::size_t, 6>> contactFeatures;
+  for (const Proximity &contact : f.selfContacts)
+    EXPECT_TRUE(contactFeatures.insert(closestFeatures(contact)).second);
+
+  // force is the gradient of the energy
+  EigenVectorX3dr force = toMatrix(f.forces.selfAvoidanceForceVec);
+  EigenVectorX3dr current_pos = toMatrix(f.vpg->inputVertexPositions);
+  const double epsilon = 1e-6;
+  toMatrix(f.vpg->inputVertexPositions) = current_pos + epsilon * force;
+  f.computeSelfAvoidanceEnergy();
+  double forwardEnergy = f.energy.selfAvoidancePenalty;
+  toMatrix(f.vpg->inputVertexPositions) = current_pos - epsilon * force;
+  f.computeSelfAvoidanceEnergy();
+  double backwardEnergy = f.energy.selfAvoidancePenalty;
+  EXPECT_NEAR((backwardEnergy - forwardEnergy) / (2 * epsilon),
+              force.squaredNorm(), 1e-4 * force.squaredNorm());
+};
+
+TEST_F(ForceTest, SelectiveRefreshTest) {
+  mem3dg::solver::System selective(topologyMatrix, vertexMatrix, p, 0);
+  mem3dg::solver::System full(topologyMatrix, vertexMatrix, p, 0);
+  selective.isSelectiveRefresh = true;
+
+  // perturb the same vertices of both systems
+  EigenVectorX3dr displacement =
+      0.05 * EigenVectorX3dr::Random(vertexMatrix.rows(), 3);
+  for (mem3dg::solver::System *f : {&selective, &full}) {
+    toMatrix(f->vpg->inputVertexPositions) += displacement;
+    f->updateConfigurations(false);
+    f->computePhysicalForcing();
+  }
+
+  auto expectApprox = [](const auto &actual, const auto &expected) {
+    EXPECT_LE((actual - expected).norm(), 1e-10 * expected.norm());
+  };
+  expectApprox(selective.vpg->faceAreas.raw(), full.vpg->faceAreas.raw());
+  expectApprox(toMatrix(selective.vpg->faceNormals),
+               toMatrix(full.vpg->faceNormals));
+  expectApprox(selective.vpg->cornerAngles.raw(),
+               full.vpg->cornerAngles.raw());
+  expectApprox(selective.vpg->edgeLengths.raw(), full.vpg->edgeLengths.raw());
+  expectApprox(selective.vpg->edgeDihedralAngles.raw(),
+               full.vpg->edgeDihedralAngles.raw());
+  expectApprox(selective.vpg->halfedgeCotanWeights.raw(),
+               full.vpg->halfedgeCotanWeights.raw());
+  expectApprox(selective.vpg->edgeCotanWeights.raw(),
+               full.vpg->edgeCotanWeights.raw());
+  expectApprox(selective.vpg->vertexDualAreas.raw(),
+               full.vpg->vertexDualAreas.raw());
+  expectApprox(selective.vpg->vertexMeanCurvatures.raw(),
+               full.vpg->vertexMeanCurvatures.raw());
+  expectApprox(selective.vpg->vertexGaussianCurvatures.raw(),
+               full.vpg->vertexGaussianCurvatures.raw());
+  expectApprox(toMatrix(selective.vpg->vertexNormals),
+               toMatrix(full.vpg->vertexNormals));
+  expectApprox(Eigen::MatrixXd(selective.cotanLaplacian.matrix),
+               Eigen::MatrixXd(full.vpg->cotanLaplacian));
+  EXPECT_NEAR(selective.volume, full.volume, 1e-10 * std::abs(full.volume));
+  EXPECT_NEAR(selective.surfaceArea, full.surfaceArea,
+              1e-10 * full.surfaceArea);
+  expectApprox(toMatrix(selective.forces.mechanicalForceVec),
+               toMatrix(full.forces.mechanicalForceVec));
+  expectApprox(selective.forces.chemicalPotential.raw(),
+               full.forces.chemicalPotential.raw());
+
+  // the sparse operators are assembled only if needed
+  EXPECT_FALSE(selective.isGeometryOperatorsCurrent);
+  EXPECT_TRUE(full.isGeometryOperatorsCurrent);
+  EXPECT_EQ(selective.refreshTimings.count("all"), 0u);
+  EXPECT_EQ(selective.refreshTimings.count("fusedSweep"), 1u);
+  for (const char *phase :
+       {"fusedSweep/faces", "fusedSweep/edges", "fusedSweep/vertices"})
+    EXPECT_EQ(selective.refreshTimings.count(phase), 1u);
+  EXPECT_EQ(selective.refreshTimings.count("cotanLaplacian"), 1u);
+  EXPECT_EQ(full.refreshTimings.count("all"), 1u);
+  selective.parameters.dirichlet.eta = 0;
+  selective.refreshTimings.clear();
+  selective.updateConfigurations(false);
+  EXPECT_EQ(selective.refreshTimings.count("cotanLaplacian"), 0u);
+
+  // an explicit refresh of the operators, as done by the python getters
+  selective.refreshGeometry(true);
+  EXPECT_TRUE(selective.isGeometryOperatorsCurrent);
+  EXPECT_EQ(selective.refreshTimings.count("all"), 1u);
+};
+
+TEST_F(ForceTest, CotanLaplacianTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> icoTopologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> icoVertexMatrix;
+  std::tie(icoTopologyMatrix, icoVertexMatrix) = getIcosphereMatrix(1, 2);
+  mem3dg::solver::System f(icoTopologyMatrix, icoVertexMatrix,
+                           closedMeshParameters(), 0);
+
+  auto expectLaplacian = [&f]() {
+    f.updateConfigurations(false);
+    const Eigen::SparseMatrix<double> &cached = f.cotanLaplacian.matrix;
+    ASSERT_EQ(cached.rows(), static_cast<long>(f.mesh->nVertices()));
+    EXPECT_EQ(cached.nonZeros(),
+              static_cast<long>(f.mesh->nVertices() + 2 * f.mesh->nEdges()));
+    Eigen::MatrixXd expected(f.vpg->cotanLaplacian);
+    EXPECT_LE((Eigen::MatrixXd(cached) - expected).norm(),
+              1e-12 * expected.norm());
+  };
+  expectLaplacian();
+
+  // values are updated in place
+  const double *values = f.cotanLaplacian.matrix.valuePtr();
+  toMatrix(f.vpg->inputVertexPositions).col(2) *= 1.1;
+  expectLaplacian();
+  EXPECT_EQ(f.cotanLaplacian.matrix.valuePtr(), values);
+
+  // pattern is rebuilt after mutation
+  splitLargestFaces(f);
+  f.mutateMesh();
+  ASSERT_GT(f.mesh->nVertices(),
+            static_cast<std::size_t>(icoVertexMatrix.rows()));
+  expectLaplacian();
+};
+
+TEST_F(ForceTest, GeodesicSolverTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> icoTopologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> icoVertexMatrix;
+  std::tie(icoTopologyMatrix, icoVertexMatrix) = getIcosphereMatrix(1, 3);
+  mem3dg::solver::System f(icoTopologyMatrix, icoVertexMatrix,
+                           closedMeshParameters(), 0);
+
+  // great circle distance on the unit sphere
+  f.updateGeodesicDistance();
+  Eigen::VectorXd distance = f.geodesicDistanceFromPtInd.raw();
+  gc::Vector3 source =
+      gc::unit(f.thePoint.interpolate(f.vpg->inputVertexPositions));
+  double maxError = 0, meanError = 0;
+  for (std::size_t i = 0; i < f.mesh->nVertices(); ++i) {
+    double cosine = gc::dot(gc::unit(f.vpg->inputVertexPositions[i]), source);
+    double error = std::abs(
+        distance[i] - std::acos(std::min(std::max(cosine, -1.0), 1.0)));
+    maxError = std::max(maxError, error);
+    meanError += error / f.mesh->nVertices();
+  }
+  EXPECT_LT(maxError, 0.1);
+  EXPECT_LT(meanError, 0.05);
+
+  // factorization is reused within the tolerance, which is exact for scaling
+  std::size_t nFactorizations = f.geodesicSolver.nFactorizations;
+  f.parameters.point.geodesicTolerance = 0.1;
+  toMatrix(f.vpg->inputVertexPositions) *= 1.001;
+  f.updateGeodesicDistance();
+  EXPECT_EQ(f.geodesicSolver.nFactorizations, nFactorizations);
+  EXPECT_LE((f.geodesicDistanceFromPtInd.raw() - 1.001 * distance).norm(),
+            1e-10 * distance.norm());
+
+  // and refactorized beyond
+  f.parameters.point.geodesicTolerance = 0;
+  f.updateGeodesicDistance();
+  EXPECT_EQ(f.geodesicSolver.nFactorizations, nFactorizations + 1);
+  EXPECT_EQ(f.geodesicSolver.nAnalyses, 1u);
+
+  // averaged Neumann and Dirichlet heat flow on a mesh with boundary, as in
+  // geometry-central
+  mem3dg::solver::System open(topologyMatrix, vertexMatrix, p, 0);
+  ASSERT_TRUE(open.mesh->hasBoundary());
+  open.updateGeodesicDistance();
+  gcs::HeatMethodDistanceSolver heatMethod(*open.vpg);
+  Eigen::VectorXd expected = heatMethod.computeDistance(open.thePoint).raw();
+  EXPECT_LE((open.geodesicDistanceFromPtInd.raw() - expected).norm(),
+            1e-3 * expected.norm());
+};
+
+TEST_F(ForceTest, BoundedGeodesicTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> icoTopologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> icoVertexMatrix;
+  std::tie(icoTopologyMatrix, icoVertexMatrix) = getIcosphereMatrix(1, 3);
+  mem3dg::solver::System f(icoTopologyMatrix, icoVertexMatrix,
+                           closedMeshParameters(), 0);
+
+  // great circle distance on the unit sphere within the radius, clamped
+  // beyond
+  const double radius = 1;
+  f.parameters.point.geodesicRadius = radius;
+  f.updateGeodesicDistance(true);
+  gc::Vector3 source =
+      gc::unit(f.thePoint.interpolate(f.vpg->inputVertexPositions));
+  double maxError = 0;
+  std::size_t nWithin = 0;
+  for (std::size_t i = 0; i < f.mesh->nVertices(); ++i) {
+    double cosine = gc::dot(gc::unit(f.vpg->inputVertexPositions[i]), source);
+    double exact = std::acos(std::min(std::max(cosine, -1.0), 1.0));
+    double distance = f.geodesicDistanceFromPtInd[i];
+    if (exact < radius - 0.1) {
+      maxError = std::max(maxError, std::abs(distance - exact));
+      ++nWithin;
+    } else if (exact > radius + 0.1) {
+      EXPECT_EQ(distance, radius);
+    }
+  }
+  EXPECT_GT(nWithin, 0u);
+  EXPECT_LT(maxError, 0.01);
+  EXPECT_LT(f.geodesicSolver.computeBoundedDistance(
+                f.connectivity, f.vpg->inputVertexPositions,
+                {{f.thePoint.nearestVertex().getIndex(), 1}}, radius,
+                f.geodesicDistanceFromPtInd.raw()),
+            f.mesh->nVertices() / 2);
+
+  // resetting the vertices touched by the previous march, from another
+  // source, matches a march into a fresh distance
+  gcs::Vertex other = f.mesh->vertex(f.mesh->nVertices() - 1);
+  f.geodesicSolver.computeBoundedDistance(
+      f.connectivity, f.vpg->inputVertexPositions, {{other.getIndex(), 1}},
+      radius, f.geodesicDistanceFromPtInd.raw());
+  Eigen::VectorXd fresh;
+  f.geodesicSolver.computeBoundedDistance(
+      f.connectivity, f.vpg->inputVertexPositions, {{other.getIndex(), 1}},
+      radius, fresh);
+  EXPECT_TRUE(f.geodesicDistanceFromPtInd.raw() == fresh);
+
+  // the radius has to enclose the protein profile
+  Parameters profileP = closedMeshParameters();
+  profileP.proteinDistribution.profile = "tanh";
+  profileP.proteinDistribution.protein0.resize(4);
+  profileP.proteinDistribution.protein0 << 0.5, 0.5, 1, 0;
+  profileP.point.geodesicRadius = 0.4;
+  EXPECT_THROW(profileP.checkParameters(false, f.mesh->nVertices()),
+               std::runtime_error);
+  profileP.point.geodesicRadius = 1;
+  EXPECT_NO_THROW(profileP.checkParameters(false, f.mesh->nVertices()));
+};
+
+TEST_F(ForceTest, TrialPotentialEnergyTest) {
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, 3> icoTopologyMatrix;
+  Eigen::Matrix<double, Eigen::Dynamic, 3> icoVertexMatrix;
+  std::tie(icoTopologyMatrix, icoVertexMatrix) = getIcosphereMatrix(1, 2);
+  Parameters openP = p, closedP = closedMeshParameters();
+  openP.selfAvoidance.mu = 0;
+  closedP.selfAvoidance.mu = 0;
+  closedP.bending.relation = "hill";
+  closedP.tension.isConstantSurfaceTension = false;
+  closedP.tension.At = 4 * constants::PI;
+  closedP.osmotic.isPreferredVolume = true;
+  closedP.osmotic.Vt = 4.0 / 3.0 * constants::PI * 0.7;
+  mem3dg::solver::System open(topologyMatrix, vertexMatrix, openP, 0);
+  mem3dg::solver::System closed(icoTopologyMatrix, icoVertexMatrix, closedP,
+                                0);
+
+  for (mem3dg::solver::System *f : {&open, &closed}) {
+    ASSERT_TRUE(f->isTrialEnergySupported());
+    EigenVectorX3dr initialPosition = toMatrix(f->vpg->inputVertexPositions);
+    EigenVectorX3dr trialPosition =
+        initialPosition +
+        0.05 * EigenVectorX3dr::Random(initialPosition.rows(), 3);
+    EigenVectorX1d trialProtein =
+        f->proteinDensity.raw() +
+        0.05 * EigenVectorX1d::Random(f->proteinDensity.raw().rows());
+
+    // the system is left untouched
+    const double initialEnergy = f->computePotentialEnergy();
+    f->computeTrialPotentialEnergy(trialPosition, trialProtein);
+    EXPECT_TRUE(toMatrix(f->vpg->inputVertexPositions) == initialPosition);
+    EXPECT_EQ(f->energy.potentialEnergy, initialEnergy);
+
+    toMatrix(f->vpg->inputVertexPositions) = trialPosition;
+    f->proteinDensity.raw() = trialProtein;
+    f->updateConfigurations(false);
+    f->computePotentialEnergy();
+    const Energy &expected = f->energy, &actual = f->trialEnergy;
+    for (auto term : {&Energy::bendingEnergy, &Energy::deviatoricEnergy,
+                      &Energy::surfaceEnergy, &Energy::pressureEnergy,
+                      &Energy::adsorptionEnergy, &Energy::aggregationEnergy,
+                      &Energy::dirichletEnergy, &Energy::proteinInteriorPenalty,
+                      &Energy::potentialEnergy}) {
+      EXPECT_NEAR(actual.*term, expected.*term,
+                  1e-10 * std::abs(expected.*term));
+    }
+  }
+
+  // the self-avoidance penalty needs updateConfigurations
+  open.parameters.selfAvoidance.mu = 1e-5;
+  EXPECT_FALSE(open.isTrialEnergySupported());
+};
 } // namespace solver
 } // namespace mem3dg
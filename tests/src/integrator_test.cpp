@@ -12,7 +12,9 @@
 //     Padmini Rangamani (prangamani@eng.ucsd.edu)
 //
 
+#include <cmath>
 #include <iostream>
+#include <string>
 
 #include <gtest/gtest.h>
 
@@ -49,6 +51,16 @@ public:
   const std::string outputDir = "/tmp";
 };
 
+// Euler integrator with its line search workspace exposed
+class WorkspaceEuler : public mem3dg::solver::integrator::Euler {
+public:
+  using Euler::Euler;
+  using Euler::initialPosition;
+  using Euler::initialProteinDensity;
+  using Euler::trialPosition;
+  using Euler::trialProteinDensity;
+};
+
 TEST_F(IntegratorTest, EulerIntegratorTest) {
   mem3dg::solver::System f(mesh, vpg, p, 0);
   mem3dg::solver::integrator::Euler integrator{f, dt, T, tSave, eps, outputDir};
@@ -66,6 +78,121 @@ TEST_F(IntegratorTest, ConjugateGradientIntegratorTest) {
   integrator.integrate();
 }
 
+TEST_F(IntegratorTest, EulerLineSearchTest) {
+  for (std::string lineSearch : {"backtrack", "moreThuente"}) {
+    mem3dg::solver::System f(mesh, vpg, p, 0);
+    mem3dg::solver::integrator::Euler integrator{f,     dt,  T,
+                                                 tSave, eps, outputDir};
+    integrator.trajFileName = "traj.nc";
+    integrator.verbosity = verbosity;
+    integrator.lineSearch = lineSearch;
+    integrator.integrate();
+    std::cout << "Euler, " << lineSearch << ": "
+              << integrator.nEnergyEvaluations << " energy evaluations"
+              << std::endl;
+    EXPECT_GT(integrator.nEnergyEvaluations, 0u);
+    EXPECT_TRUE(std::isfinite(f.energy.potentialEnergy));
+  }
+}
+
+TEST_F(IntegratorTest, ConjugateGradientLineSearchTest) {
+  for (std::string lineSearch : {"backtrack", "moreThuente"}) {
+    mem3dg::solver::System f(mesh, vpg, p, 0);
+    mem3dg::solver::integrator::ConjugateGradient integrator{
+        f, dt, T, tSave, eps, outputDir};
+    integrator.trajFileName = "traj.nc";
+    integrator.verbosity = verbosity;
+    integrator.lineSearch = lineSearch;
+    integrator.integrate();
+    std::cout << "ConjugateGradient, " << lineSearch << ": "
+              << integrator.nEnergyEvaluations << " energy evaluations"
+              << std::endl;
+    EXPECT_GT(integrator.nEnergyEvaluations, 0u);
+    EXPECT_TRUE(std::isfinite(f.energy.potentialEnergy));
+  }
+}
+
+TEST_F(IntegratorTest, WarmStartStepTest) {
+  // energy evaluations of Euler and conjugate gradient, cold then warm
+  std::size_t nEvaluations[2][2];
+  for (bool isWarmStartStep : {false, true}) {
+    mem3dg::solver::System f(mesh, vpg, p, 0);
+    mem3dg::solver::integrator::Euler euler{f,     dt,  T,
+                                            tSave, eps, outputDir};
+    euler.trajFileName = "traj.nc";
+    euler.verbosity = verbosity;
+    euler.isWarmStartStep = isWarmStartStep;
+    euler.integrate();
+    std::cout << "Euler, warm start " << isWarmStartStep << ": "
+              << euler.nEnergyEvaluations << " energy evaluations"
+              << std::endl;
+    EXPECT_GT(euler.nEnergyEvaluations, 0u);
+    nEvaluations[0][isWarmStartStep] = euler.nEnergyEvaluations;
+
+    mem3dg::solver::System g(mesh, vpg, p, 0);
+    mem3dg::solver::integrator::ConjugateGradient cg{g,     dt,  T,
+                                                     tSave, eps, outputDir};
+    cg.trajFileName = "traj.nc";
+    cg.verbosity = verbosity;
+    cg.isWarmStartStep = isWarmStartStep;
+    cg.integrate();
+    std::cout << "ConjugateGradient, warm start " << isWarmStartStep << ": "
+              << cg.nEnergyEvaluations << " energy evaluations" << std::endl;
+    EXPECT_GT(cg.nEnergyEvaluations, 0u);
+    nEvaluations[1][isWarmStartStep] = cg.nEnergyEvaluations;
+  }
+  // the warm start usually saves the backtracking from
+  // characteristicTimeStep, but the trajectories differ, so fewer evaluations
+  // are not guaranteed and only reported
+  std::cout << "warm / cold start energy evaluations: Euler "
+            << nEvaluations[0][true] << "/" << nEvaluations[0][false]
+            << ", ConjugateGradient " << nEvaluations[1][true] << "/"
+            << nEvaluations[1][false] << std::endl;
+}
+
+TEST_F(IntegratorTest, LineSearchWorkspaceTest) {
+  mem3dg::solver::Parameters proteinP = p;
+  proteinP.variation.isProteinVariation = true;
+  proteinP.proteinMobility = 1;
+  proteinP.adsorption.epsilon = -1e-3;
+  mem3dg::solver::System f(mesh, vpg, proteinP, 0);
+  WorkspaceEuler integrator{f, dt, T, tSave, eps, outputDir};
+  integrator.trajFileName = "traj.nc";
+  integrator.verbosity = verbosity;
+  integrator.step(2);
+
+  const double *workspace[4];
+  for (int search = 0; search < 3; ++search) {
+    // an uphill chemical direction is replaced by the bare gradient, in
+    // place
+    integrator.status();
+    mem3dg::EigenVectorX1d chemicalPotential = f.forces.chemicalPotential.raw();
+    ASSERT_GT(chemicalPotential.norm(), 0);
+    f.velocity = f.forces.mechanicalForceVec;
+    f.proteinVelocity.raw() = -chemicalPotential;
+    const double *direction = f.proteinVelocity.raw().data();
+    if (search == 0)
+      integrator.backtrack();
+    else if (search == 1)
+      integrator.wolfeLineSearch();
+    else
+      integrator.chemicalBacktrack();
+    EXPECT_TRUE(f.proteinVelocity.raw() == chemicalPotential);
+    EXPECT_EQ(f.proteinVelocity.raw().data(), direction);
+
+    // and the workspace is reused by the steady-state line searches
+    const double *buffers[4] = {integrator.initialPosition.data(),
+                                integrator.initialProteinDensity.data(),
+                                integrator.trialPosition.data(),
+                                integrator.trialProteinDensity.data()};
+    for (int k = 0; k < 4; ++k) {
+      if (search > 0)
+        EXPECT_EQ(buffers[k], workspace[k]);
+      workspace[k] = buffers[k];
+    }
+  }
+}
+
 // TEST_F(IntegratorTest, BFGSIntegratorTest) {
 //   mem3dg::solver::System f(mesh, vpg, p, o, 0);
 //   mem3dg::solver::integrator::BFGS integrator{
@@ -74,6 +201,39 @@ TEST_F(IntegratorTest, ConjugateGradientIntegratorTest) {
 //   integrator.integrate();
 // }
 
+TEST_F(IntegratorTest, LBFGSIntegratorTest) {
+  mem3dg::solver::System f(mesh, vpg, p, 0);
+  mem3dg::solver::integrator::LBFGS integrator{f,     dt,  T,
+                                               tSave, eps, outputDir};
+  integrator.trajFileName = "traj.nc";
+  integrator.verbosity = verbosity;
+  integrator.historyLength = 3;
+  integrator.step(10);
+  EXPECT_GT(integrator.getHistorySize(), 0u);
+  EXPECT_LE(integrator.getHistorySize(), 3u);
+  integrator.integrate();
+  EXPECT_TRUE(std::isfinite(f.energy.potentialEnergy));
+}
+
+TEST_F(IntegratorTest, LBFGSEnergyDecreaseTest) {
+  // the line searched quasi-Newton steps decrease the potential energy
+  for (std::string lineSearch : {"backtrack", "moreThuente"}) {
+    mem3dg::solver::System f(mesh, vpg, p, 0);
+    mem3dg::solver::integrator::LBFGS integrator{f,     dt,  T,
+                                                 tSave, eps, outputDir};
+    integrator.trajFileName = "traj.nc";
+    integrator.verbosity = verbosity;
+    integrator.lineSearch = lineSearch;
+    double previousEnergy = f.computePotentialEnergy();
+    for (std::size_t n = 0; n < 20; ++n) {
+      integrator.step(1);
+      double energy = f.computePotentialEnergy();
+      EXPECT_LE(energy, previousEnergy) << lineSearch << ", step " << n;
+      previousEnergy = energy;
+    }
+  }
+}
+
 TEST_F(IntegratorTest, VelocityVerletIntegratorTest) {
   mem3dg::solver::System f(mesh, vpg, p, 0);
   mem3dg::solver::integrator::VelocityVerlet integrator{f,     dt,  1,